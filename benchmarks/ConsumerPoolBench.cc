@@ -0,0 +1,80 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <broker_system/ConsumerPool.h>
+#include <broker_system/RingBuffer.h>
+
+// Compares the work-stealing ConsumerPool with N threads popping one shared
+// RingBuffer. 80% of the events belong to one hot video, every event costs a
+// little CPU to process.
+
+constexpr size_t kEvents = 400000;
+constexpr uint32_t kVideos = 1000;
+constexpr int kWork = 200;
+
+static std::atomic<uint64_t> sink{0};
+
+static void process(uint32_t video) {
+  uint64_t h = video;
+  for (int i = 0; i < kWork; ++i) h = h * 6364136223846793005ULL + 1442695040888963407ULL;
+  sink.fetch_add(h & 1, std::memory_order_relaxed);
+}
+
+static std::vector<uint32_t> make_events() {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<uint32_t> video(1, kVideos - 1);
+  std::bernoulli_distribution hot(0.8);
+  std::vector<uint32_t> events(kEvents);
+  for (auto& e : events) e = hot(gen) ? 0 : video(gen);
+  return events;
+}
+
+static double shared_ring(const std::vector<uint32_t>& events, size_t threads) {
+  RingBuffer<uint32_t> rbuf(1024);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> consumers;
+  for (size_t i = 0; i < threads; ++i) {
+    consumers.emplace_back([&]() {
+      uint32_t video;
+      while (rbuf.pop(video)) process(video);
+    });
+  }
+  for (uint32_t e : events) rbuf.push(e);
+  rbuf.close();
+  for (auto& t : consumers) t.join();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return events.size() / elapsed.count();
+}
+
+static double work_stealing(const std::vector<uint32_t>& events, size_t threads) {
+  ConsumerPoolOptions options;
+  options.workers = threads;
+  auto start = std::chrono::steady_clock::now();
+  {
+    ConsumerPool<uint32_t> pool([](const uint32_t& video, size_t) { process(video); },
+                                [](const uint32_t& video) { return video; }, options);
+    for (uint32_t e : events) pool.submit(e);
+    pool.stop();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return events.size() / elapsed.count();
+}
+
+int main() {
+  auto events = make_events();
+  size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << std::setw(8) << "threads" << std::setw(18) << "shared msg/s"
+            << std::setw(18) << "stealing msg/s" << '\n';
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    std::cout << std::setw(8) << threads << std::fixed << std::setprecision(0)
+              << std::setw(18) << shared_ring(events, threads) << std::setw(18)
+              << work_stealing(events, threads) << '\n';
+  }
+}
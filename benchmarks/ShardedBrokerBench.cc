@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include <broker_system/RingBuffer.h>
+#include <broker_system/ShardedBroker.h>
+
+// Throughput of the shard-per-core broker against one shared RingBuffer as
+// the number of cores grows. Every core runs one producer and one consumer;
+// messages are spread over all shards by key.
+
+constexpr uint64_t kEventsPerProducer = 500000;
+
+static double shared_ring(size_t cores) {
+  RingBuffer<uint64_t> rbuf(4096);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < cores; ++i) {
+    threads.emplace_back([&]() {
+      uint64_t msg;
+      while (rbuf.pop(msg)) {}
+    });
+  }
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < cores; ++i) {
+    producers.emplace_back([&]() {
+      for (uint64_t e = 0; e < kEventsPerProducer; ++e) rbuf.push(e);
+    });
+  }
+  for (auto& t : producers) t.join();
+  rbuf.close();
+  for (auto& t : threads) t.join();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return cores * kEventsPerProducer / elapsed.count();
+}
+
+static double sharded(size_t cores) {
+  ShardedBrokerOptions options;
+  options.shards = cores;
+  auto start = std::chrono::steady_clock::now();
+  {
+    ShardedBroker<uint64_t> broker([](const uint64_t&, size_t) {},
+                                   [](const uint64_t& key) { return key; }, options);
+    for (size_t shard = 0; shard < cores; ++shard) {
+      broker.run_producer(shard, [](ShardedBroker<uint64_t>::Producer& producer) {
+        for (uint64_t e = 0; e < kEventsPerProducer; ++e) producer.publish(e);
+      });
+    }
+    broker.stop();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return cores * kEventsPerProducer / elapsed.count();
+}
+
+int main() {
+  size_t max_cores = allowed_cpus().size();
+
+  std::cout << std::setw(8) << "cores" << std::setw(18) << "shared msg/s"
+            << std::setw(18) << "sharded msg/s" << '\n';
+  for (size_t cores = 1; cores <= max_cores; cores *= 2) {
+    std::cout << std::setw(8) << cores << std::fixed << std::setprecision(0)
+              << std::setw(18) << shared_ring(cores) << std::setw(18)
+              << sharded(cores) << '\n';
+  }
+}
@@ -0,0 +1,41 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <broker_system/LoadGenerator.h>
+#include <broker_system/RingBuffer.h>
+
+// Replays the README workload (1,000 videos, 10 creators, 1,000,000 users)
+// into a RingBuffer drained by one pop_bulk consumer.
+// Usage: WorkloadBench [producer threads] [events] [events per second, 0 = max]
+
+int main(int argc, char** argv) {
+  LoadProfile profile;
+  profile.threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+  profile.events = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+  profile.events_per_second = argc > 3 ? std::strtod(argv[3], nullptr) : 0;
+  profile.burst_probability = 0.01;
+
+  LoadGenerator generator(profile);
+  RingBuffer<VideoEvent> ring(4096);
+
+  uint64_t received = 0;
+  std::thread consumer([&]() {
+    std::vector<VideoEvent> batch;
+    while (ring.pop_bulk(batch, 256) != 0) {
+      received += batch.size();
+      batch.clear();
+    }
+  });
+
+  LoadStats stats = generator.run(ring);
+  ring.close();
+  consumer.join();
+
+  std::cout << std::fixed << std::setprecision(0) << "producers " << profile.threads
+            << ", events " << stats.events << ", received " << received << ", "
+            << stats.events_per_second << " msg/s in " << std::setprecision(3)
+            << stats.seconds << " s\n";
+}
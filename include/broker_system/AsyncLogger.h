@@ -0,0 +1,146 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <broker_system/SpscRing.h>
+#include <broker_system/TcpClient.h>
+
+constexpr size_t kLogTextSize = 112;
+
+enum class LogCategory : uint8_t { Incoming, Outgoing, Error, Meta };
+
+const char* to_string(LogCategory category);
+
+// Fixed-size record so that logging from push/pop never allocates.
+struct LogEntry {
+  uint64_t timestamp_us;
+  LogCategory category;
+  uint8_t length;
+  char text[kLogTextSize];
+};
+
+// Appends one RESP array command (e.g. {"RPUSH", key, value}) to out.
+void resp_append_command(std::string& out,
+                         std::initializer_list<std::string_view> args);
+
+// Destination for pipelined RESP payloads. write() receives several encoded
+// commands at once and returns how many of them the server accepted; the
+// rest are counted as sink drops.
+class RespSink {
+ public:
+  virtual ~RespSink() = default;
+  virtual size_t write(const std::string& payload, size_t commands) = 0;
+};
+
+// Sends payloads to a Redis-compatible server and consumes one reply line
+// per command, reconnecting lazily after a failure. Only simple string (+)
+// and integer (:) replies count as accepted; error replies (-ERR ...) do not.
+// A server that stops answering fails the batch after timeout instead of
+// hanging the drainer and stop().
+class TcpRespSink : public RespSink {
+ public:
+  TcpRespSink(std::string host, uint16_t port,
+              std::chrono::milliseconds timeout = std::chrono::seconds(1));
+  size_t write(const std::string& payload, size_t commands) override;
+
+ private:
+  size_t read_replies(size_t commands);
+
+  std::string host_;
+  uint16_t port_;
+  TcpClient client_;
+};
+
+struct AsyncLoggerOptions {
+  size_t ring_capacity = 4096;
+  size_t batch_size = 256;
+  std::chrono::milliseconds flush_interval{5};
+  std::string key_prefix = "broker:log:";
+};
+
+// Asynchronous logging pipeline: every calling thread owns an SpscRing of
+// LogEntry, a background drainer batches entries into pipelined RPUSH
+// commands. A thread's ring is retired when the thread exits and freed by
+// the drainer once it is empty, so short-lived threads do not pile up rings. When a ring is full the entry is dropped and counted instead of
+// blocking the caller. Every entry log() reports as accepted is flushed to
+// the sink before stop() returns.
+class AsyncLogger {
+ public:
+  explicit AsyncLogger(std::shared_ptr<RespSink> sink,
+                       AsyncLoggerOptions options = {});
+  ~AsyncLogger();
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  bool log(LogCategory category, std::string_view text);
+  void flush();
+  void stop();
+
+  uint64_t logged() const;
+  uint64_t dropped() const;
+  uint64_t flushed() const;
+  uint64_t sink_dropped() const;
+  size_t rings() const;
+
+ private:
+  struct ThreadRing {
+    explicit ThreadRing(size_t capacity) : ring(capacity) {}
+    SpscRing<LogEntry> ring;
+    alignas(kCacheLineSize) std::atomic<uint64_t> logged{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> logging{0};  // log() calls in flight
+    std::atomic<bool> retired{false};  // owning thread has exited
+  };
+
+  // Per-thread lookup from logger id to its ring. The weak_ptr tells when
+  // the logger (and so the ring) is gone and the entry can be pruned.
+  struct CachedRing {
+    uint64_t logger_id;
+    std::weak_ptr<ThreadRing> owner;
+    ThreadRing* ring;
+  };
+
+  // thread_local list of the calling thread's rings; retires them all when
+  // the thread exits.
+  struct RingCache {
+    ~RingCache();
+    std::vector<CachedRing> entries;
+  };
+
+  ThreadRing& local_ring();
+  void wait_for_loggers() const;
+  void prune_retired();
+  void drain_loop();
+  size_t drain_once();
+  void send_batch(std::string& payload, size_t& commands);
+
+  const uint64_t id_;
+  std::shared_ptr<RespSink> sink_;
+  AsyncLoggerOptions options_;
+
+  mutable std::mutex rings_mtx_;
+  std::vector<std::shared_ptr<ThreadRing>> rings_;
+  uint64_t retired_logged_ = 0;   // counters of freed rings, under rings_mtx_
+  uint64_t retired_dropped_ = 0;
+
+  std::mutex drain_mtx_;
+  std::condition_variable wake_;
+  std::atomic<bool> running_{true};
+  std::atomic<uint64_t> flushed_{0};
+  std::atomic<uint64_t> failed_{0};
+  std::thread drainer_;
+};
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef CONSUMERPOOL_H
+#define CONSUMERPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <broker_system/LockFreeRingBuffer.h>
+#include <broker_system/RingBuffer.h>
+
+#define ERROR_POOL_HANDLER "ConsumerPool needs a handler"
+
+struct ConsumerPoolOptions {
+  size_t workers = std::max(1u, std::thread::hardware_concurrency());
+  size_t queue_capacity = 1024;
+  size_t steal_batch = 64;
+};
+
+// Consumer runtime: submit() routes every message to a worker's local
+// LockFreeRingBuffer (same key -> same worker), and a worker whose queue runs
+// dry steals up to half of the fullest queue in one batch, so a burst on one
+// key is spread over idle cores. A handler may submit() back into the pool:
+// if the target queue is full, the message runs inline on the calling
+// worker instead of waiting for a queue that only workers can drain.
+template <typename T>
+class ConsumerPool {
+ public:
+  using Handler = std::function<void(const T& msg, size_t worker)>;
+  using Router = std::function<size_t(const T& msg)>;
+
+  ConsumerPool(Handler handler, Router router, ConsumerPoolOptions options = {});
+  ~ConsumerPool();
+
+  ConsumerPool(const ConsumerPool&) = delete;
+  ConsumerPool& operator=(const ConsumerPool&) = delete;
+
+  bool submit(const T& msg);
+  void drain(RingBuffer<T>& source);
+  void stop();
+
+  size_t workers() const;
+  uint64_t processed() const;
+  uint64_t processed(size_t worker) const;
+  uint64_t stolen(size_t worker) const;
+
+ private:
+  struct Worker {
+    explicit Worker(size_t capacity) : queue(capacity) {}
+    LockFreeRingBuffer<T> queue;
+    alignas(kCacheLineSize) std::atomic<uint64_t> processed{0};
+    std::atomic<uint64_t> stolen{0};
+  };
+
+  void run(size_t id);
+  size_t steal(size_t thief, std::vector<T>& batch);
+
+  // Pool and worker id of the calling thread while it runs a worker loop.
+  static inline thread_local const ConsumerPool* current_pool_ = nullptr;
+  static inline thread_local size_t current_worker_ = 0;
+
+  Handler handler_;
+  Router router_;
+  ConsumerPoolOptions options_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  alignas(kCacheLineSize) std::atomic<uint64_t> pending_{0};
+  std::atomic<bool> stopping_{false};
+};
+
+template <typename T>
+ConsumerPool<T>::ConsumerPool(Handler handler, Router router, ConsumerPoolOptions options)
+    : handler_(std::move(handler)), router_(std::move(router)), options_(options) {
+  if (!handler_) {
+    throw std::invalid_argument(ERROR_POOL_HANDLER);
+  }
+  if (options_.workers == 0) options_.workers = 1;
+  if (options_.steal_batch == 0) options_.steal_batch = 1;
+
+  workers_.reserve(options_.workers);
+  for (size_t i = 0; i < options_.workers; ++i) {
+    workers_.push_back(std::make_unique<Worker>(options_.queue_capacity));
+  }
+  threads_.reserve(options_.workers);
+  for (size_t i = 0; i < options_.workers; ++i) {
+    threads_.emplace_back(&ConsumerPool::run, this, i);
+  }
+}
+
+template <typename T>
+ConsumerPool<T>::~ConsumerPool() {
+  stop();
+}
+
+// The message is counted in pending_ before stopping_ is checked (both
+// seq_cst, pairing with stop() and the workers' exit test): either this
+// sees stopping_ and backs off, or the workers see it pending and keep
+// draining until it is pushed and processed, so a full queue never spins
+// forever and an accepted message is never left behind. The one caller the
+// workers cannot drain for is a worker itself (a handler submitting), so
+// that caller runs the message inline rather than wait.
+template <typename T>
+bool ConsumerPool<T>::submit(const T& msg) {
+  pending_.fetch_add(1);
+  if (stopping_.load()) {
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+    return false;
+  }
+  static thread_local size_t round_robin = 0;
+  size_t target = router_ ? router_(msg) : round_robin++;
+  Worker& worker = *workers_[target % workers_.size()];
+
+  while (!worker.queue.try_push(msg)) {
+    if (current_pool_ == this) {
+      Worker& self = *workers_[current_worker_];
+      handler_(msg, current_worker_);
+      self.processed.fetch_add(1, std::memory_order_relaxed);
+      pending_.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+// Fans out everything popped from a shared RingBuffer until end of stream.
+template <typename T>
+void ConsumerPool<T>::drain(RingBuffer<T>& source) {
+  T msg;
+  while (source.pop(msg)) {
+    if (!submit(msg)) break;
+  }
+}
+
+// Rejects new submits, lets the workers finish every accepted message
+// (including submits in flight), then joins them.
+template <typename T>
+void ConsumerPool<T>::stop() {
+  stopping_.store(true);
+  for (auto& thread : threads_) {
+    if (thread.joinable()) thread.join();
+  }
+}
+
+template <typename T>
+void ConsumerPool<T>::run(size_t id) {
+  current_pool_ = this;
+  current_worker_ = id;
+  Worker& self = *workers_[id];
+  std::vector<T> batch;
+  batch.reserve(options_.steal_batch);
+  size_t idle = 0;
+  T msg;
+
+  while (true) {
+    if (self.queue.try_pop(msg)) {
+      handler_(msg, id);
+      self.processed.fetch_add(1, std::memory_order_relaxed);
+      pending_.fetch_sub(1, std::memory_order_acq_rel);
+      idle = 0;
+      continue;
+    }
+
+    size_t taken = steal(id, batch);
+    if (taken != 0) {
+      for (const T& stolen : batch) handler_(stolen, id);
+      batch.clear();
+      self.processed.fetch_add(taken, std::memory_order_relaxed);
+      self.stolen.fetch_add(taken, std::memory_order_relaxed);
+      pending_.fetch_sub(taken, std::memory_order_acq_rel);
+      idle = 0;
+      continue;
+    }
+
+    if (stopping_.load() && pending_.load() == 0) {
+      return;
+    }
+    if (++idle < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+}
+
+template <typename T>
+size_t ConsumerPool<T>::steal(size_t thief, std::vector<T>& batch) {
+  size_t victim = thief;
+  size_t most = 0;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    size_t size = workers_[i]->queue.size();
+    if (i != thief && size > most) {
+      most = size;
+      victim = i;
+    }
+  }
+  if (victim == thief) {
+    return 0;
+  }
+  size_t want = std::min(options_.steal_batch, (most + 1) / 2);
+  return workers_[victim]->queue.try_pop_bulk(batch, want);
+}
+
+template <typename T>
+size_t ConsumerPool<T>::workers() const {
+  return workers_.size();
+}
+
+template <typename T>
+uint64_t ConsumerPool<T>::processed() const {
+  uint64_t total = 0;
+  for (auto& worker : workers_) {
+    total += worker->processed.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+template <typename T>
+uint64_t ConsumerPool<T>::processed(size_t worker) const {
+  return workers_.at(worker)->processed.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+uint64_t ConsumerPool<T>::stolen(size_t worker) const {
+  return workers_.at(worker)->stolen.load(std::memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef DEDUPINDEX_H
+#define DEDUPINDEX_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include <broker_system/RingBuffer.h>
+
+constexpr size_t kDedupWindow = 64;
+constexpr size_t kDedupShards = 16;
+
+// Remembers which (producer_id, sequence) pairs were already accepted using
+// only a high-water mark and a 64-bit bitmap of the sequences just below it
+// per producer. Checks are O(1). A sequence that is more than kDedupWindow
+// behind the high-water mark cannot be told apart from a duplicate and is
+// rejected as well.
+class DedupIndex {
+ public:
+  bool accept(uint32_t producer_id, uint64_t sequence);
+  void forget(uint32_t producer_id, uint64_t sequence);
+  uint64_t high_water_mark(uint32_t producer_id) const;
+  uint64_t duplicates() const;
+
+ private:
+  struct ProducerState {
+    uint64_t high = 0;
+    uint64_t window = 0;  // bit i set: sequence (high - i) was accepted
+  };
+
+  struct Shard {
+    mutable std::mutex mtx;
+    std::unordered_map<uint32_t, ProducerState> producers;
+  };
+
+  std::array<Shard, kDedupShards> shards_;
+  std::atomic<uint64_t> duplicates_{0};
+};
+
+enum class PushResult { Accepted, Duplicate, Closed };
+
+// Checks the dedup index before the message reaches the ring. T must carry
+// producer_id and sequence fields (see VideoEvent). If the ring is closed
+// the sequence is forgotten again, so the producer's retry into a reopened
+// broker is accepted rather than dropped as a duplicate.
+template <typename T, typename Policy>
+PushResult push_once(RingBuffer<T, Policy>& ring, DedupIndex& index, const T& msg) {
+  if (msg.sequence != 0 && !index.accept(msg.producer_id, msg.sequence)) {
+    return PushResult::Duplicate;
+  }
+  if (!ring.push(msg)) {
+    if (msg.sequence != 0) index.forget(msg.producer_id, msg.sequence);
+    return PushResult::Closed;
+  }
+  return PushResult::Accepted;
+}
+
+#endif
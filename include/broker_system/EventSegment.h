@@ -0,0 +1,116 @@
+#ifndef EVENTSEGMENT_H
+#define EVENTSEGMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+#include <broker_system/VideoEvent.h>
+
+#define ERROR_CODEC_UNAVAILABLE "Segment codec was not enabled at build time"
+#define ERROR_SEGMENT_CORRUPT "Segment data is truncated or corrupt"
+#define ERROR_SEGMENT_IO "Segment stream is not writable"
+
+// Optional general-purpose pass over each encoded block. Lz4 and Zstd are
+// only available when the library is built with BROKER_HAVE_LZ4 /
+// BROKER_HAVE_ZSTD (make WITH_LZ4=1 WITH_ZSTD=1).
+enum class SegmentCodec : uint8_t { None, Lz4, Zstd };
+
+bool codec_available(SegmentCodec codec);
+
+struct SegmentOptions {
+  SegmentCodec codec = SegmentCodec::None;
+  size_t block_events = 4096;
+  int level = 3;  // zstd only
+};
+
+// Writes VideoEvents as a segment: a small file header followed by
+// independent blocks. Inside a block every field is stored as its own
+// column, timestamps, sequences and ids as zigzag varints of the delta to
+// the previous event, so monotonic clocks and repeated hot videos shrink to
+// one byte per field before the optional codec runs.
+// The stream must outlive the writer. Writing the header, a block or a
+// flush throws std::runtime_error(ERROR_SEGMENT_IO) once the stream has
+// failed. Call flush() before destruction to see such errors: the
+// destructor still flushes what is pending but swallows any exception.
+class SegmentWriter {
+ public:
+  explicit SegmentWriter(std::ostream& out, SegmentOptions options = {});
+  ~SegmentWriter();
+
+  SegmentWriter(const SegmentWriter&) = delete;
+  SegmentWriter& operator=(const SegmentWriter&) = delete;
+
+  void append(const VideoEvent& event);
+  void append(const VideoEvent* events, size_t n);
+  void flush();
+
+  uint64_t events() const;
+  uint64_t bytes() const;
+
+ private:
+  void write_block();
+
+  std::ostream& out_;
+  SegmentOptions options_;
+  std::vector<VideoEvent> pending_;
+  std::string raw_;
+  std::string stored_;
+  uint64_t events_ = 0;
+  uint64_t bytes_ = 0;
+};
+
+// Streaming counterpart of SegmentWriter: only one block is decoded at a
+// time, so restoring a multi-GB segment needs memory for a single block.
+class SegmentReader {
+ public:
+  explicit SegmentReader(std::istream& in);
+
+  size_t next_block(std::vector<VideoEvent>& out);
+  bool next(VideoEvent& event);
+
+ private:
+  size_t read_block();
+
+  std::istream& in_;
+  std::string stored_;
+  std::string raw_;
+  std::vector<VideoEvent> block_;
+  size_t block_pos_ = 0;
+};
+
+// Writes the current contents of ring (oldest first) as one segment. The
+// events are copied out under a single lock first, so producers and
+// consumers may keep running; the checkpoint is the ring at that instant.
+template <typename Policy>
+size_t checkpoint(const RingBuffer<VideoEvent, Policy>& ring, std::ostream& out,
+                  SegmentOptions options = {}) {
+  std::vector<VideoEvent> events;
+  ring.copy_to(events);
+  SegmentWriter writer(out, options);
+  writer.append(events.data(), events.size());
+  writer.flush();
+  return writer.events();
+}
+
+// Pushes every event of a checkpoint back into ring, block by block.
+template <typename Policy>
+size_t restore(std::istream& in, RingBuffer<VideoEvent, Policy>& ring) {
+  SegmentReader reader(in);
+  std::vector<VideoEvent> block;
+  size_t restored = 0;
+  while (reader.next_block(block) != 0) {
+    for (const VideoEvent& event : block) {
+      if (!ring.push(event)) return restored;
+      ++restored;
+    }
+    block.clear();
+  }
+  return restored;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Resumes suspended coroutines. RingBuffer hands the coroutine waiting in
+// async_pop/async_push to the executor it was suspended with.
+class Executor {
+ public:
+  virtual ~Executor() = default;
+  virtual void post(std::coroutine_handle<> handle) = 0;
+};
+
+// Resumes the coroutine right away on the thread that made it runnable.
+class InlineExecutor : public Executor {
+ public:
+  void post(std::coroutine_handle<> handle) override;
+  static InlineExecutor& instance();
+};
+
+// Runs any number of coroutines on a fixed set of worker threads.
+class ThreadPoolExecutor : public Executor {
+ public:
+  explicit ThreadPoolExecutor(size_t threads);
+  ~ThreadPoolExecutor();
+
+  ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+  ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+  void post(std::coroutine_handle<> handle) override;
+  void stop();
+
+ private:
+  void run();
+
+  std::mutex mtx_;
+  std::condition_variable ready_;
+  std::deque<std::coroutine_handle<>> queue_;
+  bool stopped_ = false;
+  std::vector<std::thread> workers_;
+};
+
+// Fire-and-forget coroutine: starts eagerly and frees its frame on return.
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+// Awaitable that moves the current coroutine onto the given executor.
+struct ScheduleOn {
+  Executor& executor;
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) { executor.post(handle); }
+  void await_resume() const noexcept {}
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+#include <broker_system/VideoEvent.h>
+
+constexpr uint8_t kHllPrecision = 12;
+
+uint64_t hll_hash(uint64_t value);
+
+// HyperLogLog distinct counter with 2^12 one-byte registers: 4 KB per sketch
+// regardless of how many values were added, ~1.6% standard error. Merging
+// is a register-wise max, so sketches built by partitioned consumers combine
+// into the sketch of the union.
+class HyperLogLog {
+ public:
+  static constexpr size_t kRegisters = size_t{1} << kHllPrecision;
+
+  void add(uint64_t value);
+  void add_hash(uint64_t hash);
+  void merge(const HyperLogLog& other);
+  double estimate() const;
+  void clear();
+
+  const std::array<uint8_t, kRegisters>& registers() const;
+
+ private:
+  alignas(64) std::array<uint8_t, kRegisters> registers_{};
+};
+
+// Distinct viewers per video and per creator, fed with RingBuffer batches.
+class DistinctViewers {
+ public:
+  DistinctViewers();
+
+  void add(const VideoEvent& event);
+  void add_batch(const VideoEvent* events, size_t n);
+  void add_batch(const std::vector<VideoEvent>& batch);
+  void run(RingBuffer<VideoEvent>& source, size_t batch_size);
+  void merge(const DistinctViewers& other);
+
+  double video_estimate(uint32_t video_id) const;
+  double creator_estimate(uint8_t creator_id) const;
+  const HyperLogLog& video(uint32_t video_id) const;
+  const HyperLogLog& creator(uint8_t creator_id) const;
+
+ private:
+  std::vector<HyperLogLog> videos_;
+  std::vector<HyperLogLog> creators_;
+};
+
+#endif
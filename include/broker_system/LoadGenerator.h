@@ -0,0 +1,130 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+#include <broker_system/VideoEvent.h>
+
+#define ERROR_LOAD_PROFILE "LoadProfile needs threads, videos, users and a non-empty event mix"
+
+// Small, fast generator (splitmix64) usable with <random> distributions.
+class SplitMix64 {
+ public:
+  using result_type = uint64_t;
+
+  explicit SplitMix64(uint64_t seed) : state_(seed) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return UINT64_MAX; }
+  result_type operator()();
+  double uniform();
+
+ private:
+  uint64_t state_;
+};
+
+// Samples ranks 0..n-1 with P(k) ~ 1 / (k + 1)^s in O(1) (Vose alias method).
+class ZipfDistribution {
+ public:
+  ZipfDistribution(uint32_t n, double exponent);
+  uint32_t operator()(SplitMix64& rng) const;
+
+ private:
+  std::vector<double> prob_;
+  std::vector<uint32_t> alias_;
+};
+
+// Relative weights of the generated event types.
+struct EventMix {
+  double view = 70;
+  double like = 12;
+  double dislike = 2;
+  double comment = 4;
+  double watch = 12;
+};
+
+struct LoadProfile {
+  uint64_t seed = 42;
+  size_t threads = 1;
+  uint64_t events = 1000000;       // total over all threads
+  double events_per_second = 0;    // 0 = as fast as possible
+  uint32_t videos = kVideoCount;
+  uint32_t users = kUserCount;
+  double zipf_exponent = 1.0;
+  EventMix mix;
+  double burst_probability = 0;    // chance that a batch starts a burst
+  size_t burst_batches = 4;        // batches per burst
+  size_t batch_size = 64;
+  uint32_t first_producer_id = 1;  // thread i uses first_producer_id + i
+  uint64_t start_timestamp_ms = 0;
+};
+
+// Deterministic event stream of one producer thread: the same profile and
+// thread index always yield the same events, independent of timing.
+// During a burst every event targets one viral video and the batch is sent
+// without pacing; the pacer then waits longer so the average rate holds.
+class EventStream {
+ public:
+  EventStream(const LoadProfile& profile, size_t thread_index);
+
+  bool next_batch(std::vector<VideoEvent>& out, size_t n);
+  VideoEvent next();
+
+ private:
+  VideoEvent make_event(uint32_t video);
+
+  LoadProfile profile_;
+  SplitMix64 rng_;
+  ZipfDistribution zipf_;
+  std::array<double, kEventTypeCount> mix_cdf_;
+  uint32_t producer_id_;
+  uint64_t sequence_ = 0;
+  double ms_per_event_;
+  size_t burst_left_ = 0;
+  uint32_t burst_video_ = 0;
+};
+
+struct LoadStats {
+  uint64_t events = 0;
+  double seconds = 0;
+  double events_per_second = 0;
+};
+
+// Consumes one batch, returns false to stop the calling producer thread.
+using EventSink = std::function<bool(const VideoEvent* events, size_t n)>;
+// Builds one sink per producer thread.
+using SinkFactory = std::function<EventSink(size_t thread_index)>;
+
+// Wire record of one VideoEvent: timestamp_ms, sequence (8 bytes each),
+// producer_id, user_id, video_id, watch_ms (4 bytes each), creator_id and
+// type (1 byte each), all little-endian and without padding.
+constexpr size_t kEventWireSize = 34;
+
+void encode_event(const VideoEvent& event, char* out);
+VideoEvent decode_event(const char* in);
+
+SinkFactory ring_sink(RingBuffer<VideoEvent>& ring);
+// Streams kEventWireSize records over TCP, one connection per thread.
+SinkFactory loopback_sink(const std::string& host, uint16_t port);
+
+class LoadGenerator {
+ public:
+  explicit LoadGenerator(LoadProfile profile);
+
+  LoadStats run(const SinkFactory& make_sink);
+  LoadStats run(RingBuffer<VideoEvent>& ring);
+  const LoadProfile& profile() const;
+
+ private:
+  uint64_t produce(size_t thread_index, EventSink sink);
+
+  LoadProfile profile_;
+};
+
+#endif
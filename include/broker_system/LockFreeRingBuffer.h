@@ -0,0 +1,155 @@
+#ifndef LOCKFREERINGBUFFER_H
+#define LOCKFREERINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+#include <broker_system/SpscRing.h>
+
+// Bounded multi-producer/multi-consumer ring with the same non-blocking
+// surface as RingBuffer (try_push/try_pop/size/capacity). Every cell carries
+// a sequence number telling whether it is ready to be written or read, so
+// producers and consumers only contend on one CAS each (D. Vyukov's scheme).
+template <typename T>
+class LockFreeRingBuffer {
+ public:
+  explicit LockFreeRingBuffer(size_t capacity);
+
+  LockFreeRingBuffer(const LockFreeRingBuffer&) = delete;
+  LockFreeRingBuffer& operator=(const LockFreeRingBuffer&) = delete;
+
+  bool try_push(const T& msg);
+  bool try_pop(T& msg);
+  size_t try_pop_bulk(std::vector<T>& out, size_t max);
+  bool empty() const;
+  size_t size() const;
+  size_t capacity() const;
+
+ private:
+  struct Cell {
+    std::atomic<size_t> seq;
+    T data;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  alignas(kCacheLineSize) std::atomic<size_t> enqueue_pos_{0};
+  alignas(kCacheLineSize) std::atomic<size_t> dequeue_pos_{0};
+};
+
+template <typename T>
+LockFreeRingBuffer<T>::LockFreeRingBuffer(size_t capacity) {
+  if (capacity < 1) {
+    throw std::invalid_argument(ERROR_RINGBUF_SIZE);
+  }
+  size_t size = 1;
+  while (size < capacity) size <<= 1;
+  cells_ = std::make_unique<Cell[]>(size);
+  mask_ = size - 1;
+  for (size_t i = 0; i < size; ++i) {
+    cells_[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename T>
+bool LockFreeRingBuffer<T>::try_push(const T& msg) {
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[pos & mask_];
+    size_t seq = cell->seq.load(std::memory_order_acquire);
+    auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->data = msg;
+  cell->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool LockFreeRingBuffer<T>::try_pop(T& msg) {
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[pos & mask_];
+    size_t seq = cell->seq.load(std::memory_order_acquire);
+    auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  msg = cell->data;
+  cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+// Claims up to max consecutive ready cells with a single CAS on the dequeue
+// position, so a thief takes its whole batch in one step instead of
+// competing with the owner for every message.
+template <typename T>
+size_t LockFreeRingBuffer<T>::try_pop_bulk(std::vector<T>& out, size_t max) {
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  size_t count;
+  while (true) {
+    count = 0;
+    while (count < max && count <= mask_ &&
+           cells_[(pos + count) & mask_].seq.load(std::memory_order_acquire) == pos + count + 1) {
+      ++count;
+    }
+    if (count == 0) {
+      // Empty, unless another consumer moved on while we looked.
+      size_t now = dequeue_pos_.load(std::memory_order_relaxed);
+      if (now == pos) return 0;
+      pos = now;
+      continue;
+    }
+    if (dequeue_pos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+      break;
+    }
+  }
+  out.reserve(out.size() + count);
+  for (size_t i = 0; i < count; ++i) {
+    Cell& cell = cells_[(pos + i) & mask_];
+    out.push_back(std::move(cell.data));
+    cell.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+  }
+  return count;
+}
+
+template <typename T>
+bool LockFreeRingBuffer<T>::empty() const {
+  return size() == 0;
+}
+
+// Approximate while producers or consumers are active.
+template <typename T>
+size_t LockFreeRingBuffer<T>::size() const {
+  size_t head = dequeue_pos_.load(std::memory_order_acquire);
+  size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+template <typename T>
+size_t LockFreeRingBuffer<T>::capacity() const {
+  return mask_ + 1;
+}
+
+#endif
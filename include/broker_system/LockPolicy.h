@@ -0,0 +1,92 @@
+#ifndef LOCKPOLICY_H
+#define LOCKPOLICY_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#define ERROR_RINGBUF_WOULD_BLOCK "Blocking wait on a RingBuffer<T, NoLock> that can never be woken"
+
+// Locking policies of RingBuffer. Each one names the mutex and condition
+// variable types the ring is built from, so the choice costs nothing at
+// run time:
+//   Mutex    - std::mutex + std::condition_variable (default, blocking waits).
+//   SpinLock - test-and-test-and-set spin lock for short critical sections;
+//              waits park on std::condition_variable_any.
+//   NoLock   - no synchronization at all, for rings owned by one thread or
+//              guarded by an outer lock. Nothing can wake a blocked wait, so
+//              a blocking call that would wait throws instead and a timed
+//              call gives up immediately.
+
+class NullMutex {
+ public:
+  void lock() {}
+  bool try_lock() { return true; }
+  void unlock() {}
+};
+
+class NullConditionVariable {
+ public:
+  void notify_one() {}
+  void notify_all() {}
+
+  template <typename Lock, typename Predicate>
+  void wait(Lock&, Predicate ready) {
+    if (!ready()) {
+      throw std::logic_error(ERROR_RINGBUF_WOULD_BLOCK);
+    }
+  }
+
+  template <typename Lock, typename Clock, typename Duration, typename Predicate>
+  bool wait_until(Lock&, const std::chrono::time_point<Clock, Duration>&, Predicate ready) {
+    return ready();
+  }
+
+  template <typename Lock, typename Rep, typename Period, typename Predicate>
+  bool wait_for(Lock&, const std::chrono::duration<Rep, Period>&, Predicate ready) {
+    return ready();
+  }
+};
+
+class SpinMutex {
+ public:
+  void lock() {
+    while (locked_.exchange(true, std::memory_order_acquire)) {
+      while (locked_.load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  bool try_lock() {
+    return !locked_.load(std::memory_order_relaxed) &&
+           !locked_.exchange(true, std::memory_order_acquire);
+  }
+
+  void unlock() {
+    locked_.store(false, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<bool> locked_{false};
+};
+
+struct NoLock {
+  using mutex_type = NullMutex;
+  using condition_variable = NullConditionVariable;
+};
+
+struct Mutex {
+  using mutex_type = std::mutex;
+  using condition_variable = std::condition_variable;
+};
+
+struct SpinLock {
+  using mutex_type = SpinMutex;
+  using condition_variable = std::condition_variable_any;
+};
+
+#endif
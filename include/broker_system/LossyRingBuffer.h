@@ -0,0 +1,173 @@
+#ifndef LOSSYRINGBUFFER_H
+#define LOSSYRINGBUFFER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+#include <broker_system/SpscRing.h>
+
+// Overwrite-oldest ring for telemetry (one producer, one consumer): push()
+// never waits, it replaces the oldest entry once the ring is full, so the
+// producer's latency does not depend on how slow the consumer is.
+//
+// Every slot is a small seqlock. Its sequence number is odd while the
+// producer rewrites it and tells which position it holds, so the lock-free
+// consumer detects that it was lapped (or that the slot changed while being
+// copied), skips ahead to the oldest intact entry and counts what it lost.
+// The payload is stored as atomic 64-bit words, which is why T must be
+// trivially copyable.
+template <typename T>
+class LossyRingBuffer {
+  static_assert(std::is_trivially_copyable_v<T>, "LossyRingBuffer needs a trivially copyable T");
+
+ public:
+  explicit LossyRingBuffer(size_t capacity);
+
+  LossyRingBuffer(const LossyRingBuffer&) = delete;
+  LossyRingBuffer& operator=(const LossyRingBuffer&) = delete;
+
+  void push(const T& msg);
+  bool try_pop(T& msg);
+  size_t try_pop_bulk(std::vector<T>& out, size_t max);
+
+  uint64_t overwritten() const;
+  uint64_t lost() const;
+  bool empty() const;
+  size_t size() const;
+  size_t capacity() const;
+
+ private:
+  static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  // seq == 2 * (position + 1) once the slot holds position, odd while the
+  // producer is writing it, 0 if never written.
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    std::array<std::atomic<uint64_t>, kWords> words;
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  uint64_t mask_;
+
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail_{0};
+  std::atomic<uint64_t> overwritten_{0};
+
+  alignas(kCacheLineSize) std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> lost_{0};
+};
+
+template <typename T>
+LossyRingBuffer<T>::LossyRingBuffer(size_t capacity) {
+  if (capacity < 1) {
+    throw std::invalid_argument(ERROR_RINGBUF_SIZE);
+  }
+  size_t size = 1;
+  while (size < capacity) size <<= 1;
+  slots_ = std::make_unique<Slot[]>(size);
+  mask_ = size - 1;
+}
+
+template <typename T>
+void LossyRingBuffer<T>::push(const T& msg) {
+  const uint64_t pos = tail_.load(std::memory_order_relaxed);
+  if (pos - head_.load(std::memory_order_relaxed) > mask_) {
+    overwritten_.store(overwritten_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  uint64_t words[kWords] = {};
+  std::memcpy(words, &msg, sizeof(T));
+
+  Slot& slot = slots_[pos & mask_];
+  slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < kWords; ++i) {
+    slot.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot.seq.store(2 * pos + 2, std::memory_order_release);
+  tail_.store(pos + 1, std::memory_order_release);
+}
+
+template <typename T>
+bool LossyRingBuffer<T>::try_pop(T& msg) {
+  uint64_t pos = head_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[pos & mask_];
+    const uint64_t expected = 2 * pos + 2;
+    uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq < expected) {
+      return false;  // not written yet, or being written right now
+    }
+
+    if (seq == expected) {
+      uint64_t words[kWords];
+      for (size_t i = 0; i < kWords; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      seq = slot.seq.load(std::memory_order_relaxed);
+      if (seq == expected) {
+        std::memcpy(&msg, words, sizeof(T));
+        head_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+
+    // Lapped: the slot already belongs to position (seq + 1) / 2 - 1 or
+    // later. Resume at the oldest entry the producer cannot be rewriting yet.
+    const uint64_t newest = std::max(tail_.load(std::memory_order_acquire), (seq + 1) / 2);
+    const uint64_t next = std::max(pos + 1, newest - mask_);
+    lost_.store(lost_.load(std::memory_order_relaxed) + (next - pos), std::memory_order_relaxed);
+    pos = next;
+    head_.store(pos, std::memory_order_relaxed);
+  }
+}
+
+template <typename T>
+size_t LossyRingBuffer<T>::try_pop_bulk(std::vector<T>& out, size_t max) {
+  size_t taken = 0;
+  T msg;
+  while (taken < max && try_pop(msg)) {
+    out.push_back(msg);
+    ++taken;
+  }
+  return taken;
+}
+
+// Pushes that replaced an entry the consumer had not read yet, as seen by
+// the producer; lost() is the consumer's exact count of skipped entries.
+template <typename T>
+uint64_t LossyRingBuffer<T>::overwritten() const {
+  return overwritten_.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+uint64_t LossyRingBuffer<T>::lost() const {
+  return lost_.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+bool LossyRingBuffer<T>::empty() const {
+  return size() == 0;
+}
+
+template <typename T>
+size_t LossyRingBuffer<T>::size() const {
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  const uint64_t tail = tail_.load(std::memory_order_acquire);
+  return tail > head ? static_cast<size_t>(std::min(tail - head, mask_ + 1)) : 0;
+}
+
+template <typename T>
+size_t LossyRingBuffer<T>::capacity() const {
+  return mask_ + 1;
+}
+
+#endif
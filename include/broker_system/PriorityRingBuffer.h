@@ -0,0 +1,244 @@
+#ifndef PRIORITYRINGBUFFER_H
+#define PRIORITYRINGBUFFER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+
+#define ERROR_LANES "PriorityRingBuffer needs at least one lane with capacity > 0"
+#define ERROR_LANE_INDEX "Lane index out of range"
+
+enum class LaneScheduling { StrictPriority, WeightedRoundRobin };
+
+// Lane 0 has the highest priority. weights[i] is how many messages lane i
+// may take in a row under WeightedRoundRobin (missing weights count as 1).
+// starvation_limit: a non-empty lane that has been passed over this many
+// consecutive pops is served next regardless of the scheduler (0 = off).
+struct LaneConfig {
+  std::vector<size_t> capacities;
+  LaneScheduling scheduling = LaneScheduling::StrictPriority;
+  std::vector<size_t> weights;
+  size_t starvation_limit = 64;
+};
+
+// Several internal RingBuffer lanes behind a single pop/pop_bulk surface, so
+// errors and moderation events are not queued behind millions of views.
+// Each lane has its own capacity and its own not_full condition, so a full
+// view lane never blocks the control lanes and a pop only wakes a producer
+// of the lane it freed a slot in. Lanes are only touched under mtx_, so they use the NoLock
+// policy instead of locking a second time.
+template <typename T>
+class PriorityRingBuffer {
+ public:
+  explicit PriorityRingBuffer(LaneConfig config);
+
+  bool push(const T& msg, size_t lane);
+  bool try_push(const T& msg, size_t lane);
+  bool pop(T& msg);
+  bool try_pop(T& msg);
+  template <typename Rep, typename Period>
+  bool pop_for(T& msg, const std::chrono::duration<Rep, Period>& timeout);
+  size_t pop_bulk(std::vector<T>& out, size_t max);
+
+  void close();
+  bool closed() const;
+  size_t lanes() const;
+  size_t size() const;
+  size_t size(size_t lane) const;
+
+ private:
+  size_t pick_lane_locked();
+  void pop_locked(T& msg);
+
+  LaneConfig config_;
+  std::vector<std::unique_ptr<RingBuffer<T, NoLock>>> lanes_;
+  std::vector<size_t> skipped_;
+  size_t current_ = 0;
+  size_t credit_ = 0;
+  size_t count_ = 0;
+  bool closed_ = false;
+  mutable std::mutex mtx_;
+  std::vector<std::condition_variable> not_full_;  // one per lane
+  std::condition_variable not_empty_;
+};
+
+template <typename T>
+PriorityRingBuffer<T>::PriorityRingBuffer(LaneConfig config)
+    : config_(std::move(config)), not_full_(config_.capacities.size()) {
+  if (config_.capacities.empty()) {
+    throw std::invalid_argument(ERROR_LANES);
+  }
+  for (size_t capacity : config_.capacities) {
+    if (capacity < 1) {
+      throw std::invalid_argument(ERROR_LANES);
+    }
+    lanes_.push_back(std::make_unique<RingBuffer<T, NoLock>>(capacity));
+  }
+  config_.weights.resize(lanes_.size(), 1);
+  for (size_t& weight : config_.weights) {
+    if (weight == 0) weight = 1;
+  }
+  skipped_.assign(lanes_.size(), 0);
+  credit_ = config_.weights[0];
+}
+
+template <typename T>
+bool PriorityRingBuffer<T>::push(const T& msg, size_t lane) {
+  if (lane >= lanes_.size()) {
+    throw std::out_of_range(ERROR_LANE_INDEX);
+  }
+  RingBuffer<T, NoLock>& ring = *lanes_[lane];
+  std::unique_lock<std::mutex> lock(mtx_);
+  not_full_[lane].wait(lock, [&] () {return closed_ || !ring.full();});
+  if (closed_) {
+    return false;
+  }
+  ring.try_push(msg);
+  ++count_;
+  not_empty_.notify_one();
+  return true;
+}
+
+template <typename T>
+bool PriorityRingBuffer<T>::try_push(const T& msg, size_t lane) {
+  if (lane >= lanes_.size()) {
+    throw std::out_of_range(ERROR_LANE_INDEX);
+  }
+  std::scoped_lock<std::mutex> lock(mtx_);
+  if (closed_ || !lanes_[lane]->try_push(msg)) {
+    return false;
+  }
+  ++count_;
+  not_empty_.notify_one();
+  return true;
+}
+
+// Like RingBuffer::pop: returns false only once closed and drained.
+template <typename T>
+bool PriorityRingBuffer<T>::pop(T& msg) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  not_empty_.wait(lock, [this] () {return closed_ || count_ != 0;});
+  if (count_ == 0) {
+    return false;
+  }
+  pop_locked(msg);
+  return true;
+}
+
+template <typename T>
+bool PriorityRingBuffer<T>::try_pop(T& msg) {
+  std::scoped_lock<std::mutex> lock(mtx_);
+  if (count_ == 0) {
+    return false;
+  }
+  pop_locked(msg);
+  return true;
+}
+
+template <typename T>
+template <typename Rep, typename Period>
+bool PriorityRingBuffer<T>::pop_for(T& msg, const std::chrono::duration<Rep, Period>& timeout) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (!not_empty_.wait_for(lock, timeout, [this] () {return closed_ || count_ != 0;}) || count_ == 0) {
+    return false;
+  }
+  pop_locked(msg);
+  return true;
+}
+
+// Every message of the batch is scheduled individually, so a bulk pop
+// respects priorities and weights exactly like repeated pop() calls. As
+// with RingBuffer::pop_bulk, 0 means end of stream and max must be > 0.
+template <typename T>
+size_t PriorityRingBuffer<T>::pop_bulk(std::vector<T>& out, size_t max) {
+  if (max == 0) {
+    throw std::invalid_argument(ERROR_BULK_SIZE);
+  }
+  std::unique_lock<std::mutex> lock(mtx_);
+  not_empty_.wait(lock, [this] () {return closed_ || count_ != 0;});
+  size_t taken = std::min(max, count_);
+  out.reserve(out.size() + taken);
+  for (size_t i = 0; i < taken; ++i) {
+    out.emplace_back();
+    pop_locked(out.back());
+  }
+  return taken;
+}
+
+template <typename T>
+void PriorityRingBuffer<T>::pop_locked(T& msg) {
+  size_t lane = pick_lane_locked();
+  lanes_[lane]->try_pop(msg);
+  --count_;
+  for (size_t i = 0; i < lanes_.size(); ++i) {
+    skipped_[i] = (i == lane || lanes_[i]->empty()) ? 0 : skipped_[i] + 1;
+  }
+  not_full_[lane].notify_one();
+}
+
+template <typename T>
+size_t PriorityRingBuffer<T>::pick_lane_locked() {
+  if (config_.starvation_limit != 0) {
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+      if (skipped_[i] >= config_.starvation_limit) {
+        return i;
+      }
+    }
+  }
+
+  if (config_.scheduling == LaneScheduling::StrictPriority) {
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+      if (!lanes_[i]->empty()) {
+        return i;
+      }
+    }
+  }
+
+  // WeightedRoundRobin: stay on the current lane while it has credit and
+  // messages, otherwise move on to the next non-empty lane.
+  if (credit_ == 0 || lanes_[current_]->empty()) {
+    do {
+      current_ = (current_ + 1) % lanes_.size();
+    } while (lanes_[current_]->empty());
+    credit_ = config_.weights[current_];
+  }
+  --credit_;
+  return current_;
+}
+
+template <typename T>
+void PriorityRingBuffer<T>::close() {
+  std::scoped_lock<std::mutex> lock(mtx_);
+  closed_ = true;
+  for (std::condition_variable& not_full : not_full_) not_full.notify_all();
+  not_empty_.notify_all();
+}
+
+template <typename T>
+bool PriorityRingBuffer<T>::closed() const {
+  std::scoped_lock<std::mutex> lock(mtx_);
+  return closed_;
+}
+
+template <typename T>
+size_t PriorityRingBuffer<T>::lanes() const {
+  return lanes_.size();
+}
+
+template <typename T>
+size_t PriorityRingBuffer<T>::size() const {
+  std::scoped_lock<std::mutex> lock(mtx_);
+  return count_;
+}
+
+template <typename T>
+size_t PriorityRingBuffer<T>::size(size_t lane) const {
+  return lanes_.at(lane)->size();
+}
+
+#endif
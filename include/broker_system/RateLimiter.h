@@ -0,0 +1,109 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
+#include <broker_system/RingBuffer.h>
+
+#define ERROR_TOKEN_BUCKET "Token bucket rate and burst must be greater than 0"
+#define ERROR_MIN_FACTOR "Adaptive rate min_factor must be in (0, 1]"
+
+// Classic token bucket: tokens refill at rate per second up to burst.
+// Not thread-safe: every producer owns its own bucket.
+class TokenBucket {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  TokenBucket(double rate, double burst);
+
+  bool try_acquire(double tokens = 1);
+  void acquire(double tokens = 1);
+  void set_rate(double rate);
+  double rate() const;
+  double available();
+
+ private:
+  void refill(Clock::time_point now);
+
+  double rate_;
+  double burst_;
+  double tokens_;
+  Clock::time_point last_;
+};
+
+// Per-producer limiter that follows the pressure() level of a RingBuffer,
+// so the watermarks set with set_watermarks() are the only thresholds:
+// full speed while Normal, then the rate falls linearly with the fill level
+// across the Elevated band to min_factor * base_rate at High. Producers
+// slow down before push() hits the hard block instead of falling off a
+// latency cliff.
+template <typename T>
+class AdaptiveRateLimiter {
+ public:
+  AdaptiveRateLimiter(const RingBuffer<T>& ring, double base_rate, double burst, double min_factor = 0.05);
+
+  void acquire(size_t n = 1);
+  bool try_acquire(size_t n = 1);
+  double current_rate() const;
+
+ private:
+  void adapt();
+
+  const RingBuffer<T>& ring_;
+  double base_rate_;
+  double min_factor_;
+  TokenBucket bucket_;
+};
+
+template <typename T>
+AdaptiveRateLimiter<T>::AdaptiveRateLimiter(const RingBuffer<T>& ring, double base_rate, double burst,
+                                            double min_factor)
+    : ring_(ring), base_rate_(base_rate), min_factor_(min_factor), bucket_(base_rate, burst) {
+  if (!(min_factor_ > 0 && min_factor_ <= 1)) {
+    throw std::invalid_argument(ERROR_MIN_FACTOR);
+  }
+}
+
+template <typename T>
+void AdaptiveRateLimiter<T>::acquire(size_t n) {
+  adapt();
+  bucket_.acquire(static_cast<double>(n));
+}
+
+template <typename T>
+bool AdaptiveRateLimiter<T>::try_acquire(size_t n) {
+  adapt();
+  return bucket_.try_acquire(static_cast<double>(n));
+}
+
+template <typename T>
+double AdaptiveRateLimiter<T>::current_rate() const {
+  return bucket_.rate();
+}
+
+template <typename T>
+void AdaptiveRateLimiter<T>::adapt() {
+  double factor = 1.0;
+  switch (ring_.pressure()) {
+    case PressureLevel::Normal:
+      break;
+    case PressureLevel::Elevated: {
+      // Inside the band low <= size() < high, so high > low here.
+      const double low = static_cast<double>(ring_.low_watermark());
+      const double high = static_cast<double>(ring_.high_watermark());
+      const double fill = std::clamp(static_cast<double>(ring_.size()), low, high);
+      factor = 1.0 - (1.0 - min_factor_) * (fill - low) / (high - low);
+      break;
+    }
+    case PressureLevel::High:
+    case PressureLevel::Full:
+      factor = min_factor_;
+      break;
+  }
+  bucket_.set_rate(base_rate_ * factor);
+}
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef RETAINEDLOG_H
+#define RETAINEDLOG_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+#define ERROR_RETENTION "Retention must allow at least one message"
+#define ERROR_OFFSET_RANGE "Offset is outside the retained log"
+
+// Messages are evicted oldest-first once either limit is exceeded.
+// max_bytes == 0 disables the byte limit.
+struct RetentionPolicy {
+  size_t max_messages = 1 << 16;
+  size_t max_bytes = 0;
+};
+
+// Retained-log mode of the broker: appended messages are not consumed by
+// reading. Each one stays addressable by a monotonically increasing 64-bit
+// offset until retention evicts it, so a restarted consumer can seek back
+// and replay. Storage is a power-of-two ring, so a batched read is at most
+// two contiguous copies.
+template <typename T>
+class RetainedLog {
+ public:
+  using SizeFn = std::function<size_t(const T&)>;
+
+  class Cursor;
+
+  explicit RetainedLog(RetentionPolicy policy, SizeFn size_of = nullptr);
+
+  uint64_t append(const T& msg);
+  size_t read(uint64_t offset, std::vector<T>& out, size_t max) const;
+  template <typename Rep, typename Period>
+  bool wait_for(uint64_t offset, const std::chrono::duration<Rep, Period>& timeout) const;
+  Cursor cursor(uint64_t offset);
+
+  uint64_t begin_offset() const;
+  uint64_t end_offset() const;
+  size_t size() const;
+  size_t bytes() const;
+
+  // Sequential reader. If retention overtakes it, it skips to the oldest
+  // retained offset and counts what it missed in lagged().
+  class Cursor {
+   public:
+    Cursor(RetainedLog& log, uint64_t offset);
+
+    uint64_t seek(uint64_t offset);
+    size_t next(std::vector<T>& out, size_t max);
+    template <typename Rep, typename Period>
+    size_t next_wait(std::vector<T>& out, size_t max, const std::chrono::duration<Rep, Period>& timeout);
+    uint64_t position() const;
+    uint64_t lagged() const;
+
+   private:
+    RetainedLog& log_;
+    uint64_t position_;
+    uint64_t lagged_ = 0;
+  };
+
+ private:
+  void evict_locked(size_t incoming);
+  size_t copy_locked(uint64_t offset, std::vector<T>& out, size_t max) const;
+
+  RetentionPolicy policy_;
+  SizeFn size_of_;
+  std::vector<T> slots_;
+  std::vector<size_t> sizes_;
+  size_t mask_;
+  uint64_t begin_ = 0;
+  uint64_t end_ = 0;
+  size_t bytes_ = 0;
+  mutable std::shared_mutex mtx_;
+  mutable std::condition_variable_any appended_;
+};
+
+// RetainedLog
+template <typename T>
+RetainedLog<T>::RetainedLog(RetentionPolicy policy, SizeFn size_of)
+    : policy_(policy), size_of_(std::move(size_of)) {
+  if (policy_.max_messages < 1) {
+    throw std::invalid_argument(ERROR_RETENTION);
+  }
+  size_t capacity = 1;
+  while (capacity < policy_.max_messages) capacity <<= 1;
+  slots_.resize(capacity);
+  sizes_.resize(capacity);
+  mask_ = capacity - 1;
+}
+
+template <typename T>
+uint64_t RetainedLog<T>::append(const T& msg) {
+  const size_t size = size_of_ ? size_of_(msg) : sizeof(T);
+  uint64_t offset;
+  {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    evict_locked(size);
+    offset = end_;
+    slots_[offset & mask_] = msg;
+    sizes_[offset & mask_] = size;
+    bytes_ += size;
+    ++end_;
+  }
+  appended_.notify_all();
+  return offset;
+}
+
+// Makes room for a message of incoming bytes. The newest message is always
+// kept, even if it alone exceeds max_bytes. An evicted slot is reset so the
+// payload it held is released right away rather than when the ring wraps
+// around to it.
+template <typename T>
+void RetainedLog<T>::evict_locked(size_t incoming) {
+  while (end_ - begin_ >= policy_.max_messages ||
+         (policy_.max_bytes != 0 && bytes_ + incoming > policy_.max_bytes && end_ != begin_)) {
+    bytes_ -= sizes_[begin_ & mask_];
+    slots_[begin_ & mask_] = T{};
+    ++begin_;
+  }
+}
+
+// Copies up to max messages starting at offset, which must not be evicted.
+template <typename T>
+size_t RetainedLog<T>::read(uint64_t offset, std::vector<T>& out, size_t max) const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  if (offset < begin_ || offset > end_) {
+    throw std::out_of_range(ERROR_OFFSET_RANGE);
+  }
+  return copy_locked(offset, out, max);
+}
+
+template <typename T>
+size_t RetainedLog<T>::copy_locked(uint64_t offset, std::vector<T>& out, size_t max) const {
+  const size_t count = static_cast<size_t>(std::min<uint64_t>(max, end_ - offset));
+  const size_t first = offset & mask_;
+  const size_t head = std::min(count, slots_.size() - first);
+  out.insert(out.end(), slots_.begin() + first, slots_.begin() + first + head);
+  out.insert(out.end(), slots_.begin(), slots_.begin() + (count - head));
+  return count;
+}
+
+template <typename T>
+template <typename Rep, typename Period>
+bool RetainedLog<T>::wait_for(uint64_t offset, const std::chrono::duration<Rep, Period>& timeout) const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return appended_.wait_for(lock, timeout, [this, offset] () {return end_ > offset;});
+}
+
+template <typename T>
+RetainedLog<T>::Cursor RetainedLog<T>::cursor(uint64_t offset) {
+  return Cursor(*this, offset);
+}
+
+template <typename T>
+uint64_t RetainedLog<T>::begin_offset() const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return begin_;
+}
+
+template <typename T>
+uint64_t RetainedLog<T>::end_offset() const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return end_;
+}
+
+template <typename T>
+size_t RetainedLog<T>::size() const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return end_ - begin_;
+}
+
+template <typename T>
+size_t RetainedLog<T>::bytes() const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return bytes_;
+}
+
+// Cursor
+template <typename T>
+RetainedLog<T>::Cursor::Cursor(RetainedLog& log, uint64_t offset) : log_(log), position_(0) {
+  seek(offset);
+}
+
+// Returns the effective position: an evicted offset is clamped to the
+// oldest retained one, an offset past the end throws.
+template <typename T>
+uint64_t RetainedLog<T>::Cursor::seek(uint64_t offset) {
+  std::shared_lock<std::shared_mutex> lock(log_.mtx_);
+  if (offset > log_.end_) {
+    throw std::out_of_range(ERROR_OFFSET_RANGE);
+  }
+  position_ = std::max(offset, log_.begin_);
+  return position_;
+}
+
+template <typename T>
+size_t RetainedLog<T>::Cursor::next(std::vector<T>& out, size_t max) {
+  std::shared_lock<std::shared_mutex> lock(log_.mtx_);
+  if (position_ < log_.begin_) {
+    lagged_ += log_.begin_ - position_;
+    position_ = log_.begin_;
+  }
+  size_t count = log_.copy_locked(position_, out, max);
+  position_ += count;
+  return count;
+}
+
+template <typename T>
+template <typename Rep, typename Period>
+size_t RetainedLog<T>::Cursor::next_wait(std::vector<T>& out, size_t max, const std::chrono::duration<Rep, Period>& timeout) {
+  if (!log_.wait_for(position_, timeout)) {
+    return 0;
+  }
+  return next(out, max);
+}
+
+template <typename T>
+uint64_t RetainedLog<T>::Cursor::position() const {
+  return position_;
+}
+
+template <typename T>
+uint64_t RetainedLog<T>::Cursor::lagged() const {
+  return lagged_;
+}
+
+#endif
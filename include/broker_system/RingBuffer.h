@@ -8,20 +8,61 @@
 #include <mutex>
 #include <condition_variable>
 #include <optional>
+#include <chrono>
+#include <coroutine>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include <broker_system/Executor.h>
+#include <broker_system/LockPolicy.h>
 
 #define ERROR_RINGBUF_SIZE "Capacity must be greater than 0"
+#define ERROR_WATERMARKS "Watermarks must satisfy low <= high <= capacity"
+#define ERROR_BULK_SIZE "Bulk pop size must be greater than 0"
 
 constexpr size_t kBufSizeLockMode = 3;
 
-template <typename T>
+// Occupancy bands delimited by the low/high watermarks of a RingBuffer.
+enum class PressureLevel : uint8_t { Normal, Elevated, High, Full };
+
+template <typename T, typename Policy = Mutex>
 class RingBuffer {
  public:
   explicit RingBuffer(std::optional<size_t> capacity);
 
-  void push(const T& msg);
-  void pop(T& msg);
+  bool push(const T& msg);
+  bool pop(T& msg);
   bool try_push(const T& msg);
   bool try_pop(T& msg);
+
+  template <typename Rep, typename Period>
+  bool push_for(const T& msg, const std::chrono::duration<Rep, Period>& timeout);
+  template <typename Clock, typename Duration>
+  bool push_until(const T& msg, const std::chrono::time_point<Clock, Duration>& deadline);
+  template <typename Rep, typename Period>
+  bool pop_for(T& msg, const std::chrono::duration<Rep, Period>& timeout);
+  template <typename Clock, typename Duration>
+  bool pop_until(T& msg, const std::chrono::time_point<Clock, Duration>& deadline);
+
+  size_t pop_bulk(std::vector<T>& out, size_t max);
+  size_t try_pop_bulk(std::vector<T>& out, size_t max);
+
+  void close();
+  bool closed() const;
+
+  using PressureCallback = std::function<void(PressureLevel)>;
+  void set_watermarks(size_t low, size_t high, PressureCallback on_change = nullptr);
+  PressureLevel pressure() const;
+  size_t low_watermark() const;
+  size_t high_watermark() const;
+  double fill_ratio() const;
+
+  class PopAwaiter;
+  class PushAwaiter;
+  PopAwaiter async_pop(Executor& executor = InlineExecutor::instance());
+  PushAwaiter async_push(const T& msg, Executor& executor = InlineExecutor::instance());
+
   bool full() const;
   bool empty() const;
   void show() const;
@@ -29,6 +70,7 @@ class RingBuffer {
   size_t capacity() const;
   size_t available() const;
   std::tuple<size_t, size_t, size_t> snapshot() const;
+  size_t copy_to(std::vector<T>& out) const;
 
 	class Iterator {
 		public:
@@ -86,19 +128,101 @@ class RingBuffer {
 	ConstIterator cend() const;
 
  private:
-  mutable std::mutex mtx_;
-  std::condition_variable not_full_;
-  std::condition_variable not_empty_;
+  // Suspended async_pop/async_push coroutines are linked through the
+  // awaiter objects living in their frames, so waiting allocates nothing.
+  struct AwaitNode {
+    AwaitNode* next = nullptr;
+    std::coroutine_handle<> handle;
+    Executor* executor = nullptr;
+  };
+
+  struct WaiterList {
+    AwaitNode* head = nullptr;
+    AwaitNode* tail = nullptr;
+
+    void push_back(AwaitNode* node) {
+      node->next = nullptr;
+      if (tail) tail->next = node; else head = node;
+      tail = node;
+    }
+    AwaitNode* pop_front() {
+      AwaitNode* node = head;
+      if (node) {
+        head = node->next;
+        if (!head) tail = nullptr;
+      }
+      return node;
+    }
+    AwaitNode* take_all() {
+      AwaitNode* node = head;
+      head = tail = nullptr;
+      return node;
+    }
+  };
+
+  AwaitNode* push_locked(const T& msg);
+  AwaitNode* pop_locked(T& msg);
+  size_t pop_bulk_locked(std::vector<T>& out, size_t max, WaiterList& woken);
+  void update_pressure_locked();
+  static PressureLevel level_for(size_t fill, size_t low, size_t high, size_t capacity);
+  static void resume(AwaitNode* node);
+  static void resume_all(AwaitNode* node);
+
+  using MutexType = typename Policy::mutex_type;
+  using CondVar = typename Policy::condition_variable;
+
+  mutable MutexType mtx_;
+  CondVar not_full_;
+  CondVar not_empty_;
   std::vector<T> buffer_;
   size_t front_ = 0;
   size_t back_ = 0;
   size_t count_ = 0;
+  std::atomic<size_t> fill_{0};
+  std::atomic<size_t> low_mark_;
+  std::atomic<size_t> high_mark_;
+  PressureLevel level_ = PressureLevel::Normal;
+  PressureCallback on_pressure_;
   size_t capacity_;
+  std::atomic<bool> closed_{false};
+  WaiterList pop_waiters_;
+  WaiterList push_waiters_;
+};
+
+template <typename T, typename Policy>
+class RingBuffer<T, Policy>::PopAwaiter : public RingBuffer<T, Policy>::AwaitNode {
+ public:
+  PopAwaiter(RingBuffer& ring, Executor& executor);
+
+  bool await_ready() const noexcept;
+  bool await_suspend(std::coroutine_handle<> handle);
+  std::optional<T> await_resume();
+
+ private:
+  friend class RingBuffer;
+  RingBuffer& ring_;
+  std::optional<T> result_;
+};
+
+template <typename T, typename Policy>
+class RingBuffer<T, Policy>::PushAwaiter : public RingBuffer<T, Policy>::AwaitNode {
+ public:
+  PushAwaiter(RingBuffer& ring, const T& msg, Executor& executor);
+
+  bool await_ready() const noexcept;
+  bool await_suspend(std::coroutine_handle<> handle);
+  bool await_resume() const noexcept;
+
+ private:
+  friend class RingBuffer;
+  RingBuffer& ring_;
+  T msg_;
+  bool ok_ = false;
 };
 
 // RingBuffer
-template <typename T>
-RingBuffer<T>::RingBuffer(std::optional<size_t> capacity) {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::RingBuffer(std::optional<size_t> capacity) {
   if (capacity == std::nullopt) {
     capacity_ = kBufSizeLockMode + 1; // 3 entries + 1 shadow-cell
   }
@@ -109,143 +233,442 @@ RingBuffer<T>::RingBuffer(std::optional<size_t> capacity) {
     capacity_ = *capacity + 1;
   }
   buffer_.resize(capacity_);
+  low_mark_ = std::max<size_t>((capacity_ - 1) / 2, 1);
+  high_mark_ = std::max<size_t>((capacity_ - 1) * 4 / 5, low_mark_);
 }
 
-template <typename T>
-void RingBuffer<T>::push(const T& msg) {
-  std::unique_lock<std::mutex> lock(mtx_);
-  not_full_.wait(lock, [this] () {return count_ < capacity_ - 1;} );
-
+// A suspended async_pop only exists while the buffer is empty, so the message
+// is handed to it directly. The returned waiter must be resumed after unlock.
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::AwaitNode* RingBuffer<T, Policy>::push_locked(const T& msg) {
+  if (AwaitNode* node = pop_waiters_.pop_front()) {
+    static_cast<PopAwaiter*>(node)->result_ = msg;
+    return node;
+  }
   buffer_[back_] = msg;
   ++count_;
   back_ = (back_ + 1) % capacity_;
-
+  update_pressure_locked();
   not_empty_.notify_one();
+  return nullptr;
 }
 
-template <typename T>
-bool RingBuffer<T>::try_push(const T& msg) {
-  std::scoped_lock<std::mutex> lock(mtx_);
-  if (count_ < capacity_ - 1) {
-    buffer_[back_] = msg;
+// The freed slot goes to the oldest suspended async_push first.
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::AwaitNode* RingBuffer<T, Policy>::pop_locked(T& msg) {
+  msg = buffer_[front_];
+  --count_;
+  front_ = (front_ + 1) % capacity_;
+  if (AwaitNode* node = push_waiters_.pop_front()) {
+    auto* waiter = static_cast<PushAwaiter*>(node);
+    buffer_[back_] = waiter->msg_;
     ++count_;
     back_ = (back_ + 1) % capacity_;
-    not_empty_.notify_one();
+    waiter->ok_ = true;
+    return node;
+  }
+  update_pressure_locked();
+  not_full_.notify_one();
+  return nullptr;
+}
+
+// fill_ mirrors count_ so size() and the pressure can be read without the lock.
+// The callback runs under the buffer lock: it must be short and may only
+// call the lock-free getters of this RingBuffer.
+template <typename T, typename Policy>
+void RingBuffer<T, Policy>::update_pressure_locked() {
+  fill_.store(count_, std::memory_order_release);
+  PressureLevel level = level_for(count_, low_mark_.load(std::memory_order_relaxed),
+                                  high_mark_.load(std::memory_order_relaxed), capacity_ - 1);
+  if (level != level_) {
+    level_ = level;
+    if (on_pressure_) on_pressure_(level);
+  }
+}
+
+template <typename T, typename Policy>
+PressureLevel RingBuffer<T, Policy>::level_for(size_t fill, size_t low, size_t high, size_t capacity) {
+  if (fill >= capacity) return PressureLevel::Full;
+  if (fill >= high) return PressureLevel::High;
+  if (fill >= low) return PressureLevel::Elevated;
+  return PressureLevel::Normal;
+}
+
+template <typename T, typename Policy>
+void RingBuffer<T, Policy>::resume(AwaitNode* node) {
+  if (node) {
+    node->executor->post(node->handle);
+  }
+}
+
+template <typename T, typename Policy>
+void RingBuffer<T, Policy>::resume_all(AwaitNode* node) {
+  while (node) {
+    AwaitNode* next = node->next;
+    resume(node);
+    node = next;
+  }
+}
+
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::push(const T& msg) {
+  std::unique_lock<MutexType> lock(mtx_);
+  not_full_.wait(lock, [this] () {return closed_ || count_ < capacity_ - 1;} );
+  if (closed_) {
+    return false;
+  }
+  AwaitNode* waiter = push_locked(msg);
+  lock.unlock();
+  resume(waiter);
+  return true;
+}
+
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::try_push(const T& msg) {
+  std::unique_lock<MutexType> lock(mtx_);
+  if (!closed_ && count_ < capacity_ - 1) {
+    AwaitNode* waiter = push_locked(msg);
+    lock.unlock();
+    resume(waiter);
     return true;
   }
   return false;
 }
 
-template <typename T>
-void RingBuffer<T>::pop(T& msg) {
-  std::unique_lock<std::mutex> lock(mtx_);
-  not_empty_.wait(lock, [this] () {return count_ != 0;});
+template <typename T, typename Policy>
+template <typename Rep, typename Period>
+bool RingBuffer<T, Policy>::push_for(const T& msg, const std::chrono::duration<Rep, Period>& timeout) {
+  return push_until(msg, std::chrono::steady_clock::now() + timeout);
+}
 
-  msg = buffer_[front_];
-  --count_;
-  front_ = (front_ + 1) % capacity_;
+template <typename T, typename Policy>
+template <typename Clock, typename Duration>
+bool RingBuffer<T, Policy>::push_until(const T& msg, const std::chrono::time_point<Clock, Duration>& deadline) {
+  std::unique_lock<MutexType> lock(mtx_);
+  if (!not_full_.wait_until(lock, deadline, [this] () {return closed_ || count_ < capacity_ - 1;}) || closed_) {
+    return false;
+  }
+  AwaitNode* waiter = push_locked(msg);
+  lock.unlock();
+  resume(waiter);
+  return true;
+}
 
-  not_full_.notify_one();
+// Once closed, pop() keeps draining the remaining items and returns false
+// only when the buffer is empty: that is the end-of-stream signal.
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::pop(T& msg) {
+  std::unique_lock<MutexType> lock(mtx_);
+  not_empty_.wait(lock, [this] () {return closed_ || count_ != 0;});
+  if (count_ == 0) {
+    return false;
+  }
+  AwaitNode* waiter = pop_locked(msg);
+  lock.unlock();
+  resume(waiter);
+  return true;
 }
 
-template <typename T>
-bool RingBuffer<T>::try_pop(T& msg) {
-  std::scoped_lock<std::mutex> lock(mtx_);
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::try_pop(T& msg) {
+  std::unique_lock<MutexType> lock(mtx_);
   if (count_) {
-    msg = buffer_[front_];
-    --count_;
-    front_ = (front_ + 1) % capacity_;
-    not_full_.notify_one();
+    AwaitNode* waiter = pop_locked(msg);
+    lock.unlock();
+    resume(waiter);
     return true;
   }
   return false;
 }
 
-template <typename T>
-size_t RingBuffer<T>::capacity() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
+template <typename T, typename Policy>
+template <typename Rep, typename Period>
+bool RingBuffer<T, Policy>::pop_for(T& msg, const std::chrono::duration<Rep, Period>& timeout) {
+  return pop_until(msg, std::chrono::steady_clock::now() + timeout);
+}
+
+template <typename T, typename Policy>
+template <typename Clock, typename Duration>
+bool RingBuffer<T, Policy>::pop_until(T& msg, const std::chrono::time_point<Clock, Duration>& deadline) {
+  std::unique_lock<MutexType> lock(mtx_);
+  if (!not_empty_.wait_until(lock, deadline, [this] () {return closed_ || count_ != 0;}) || count_ == 0) {
+    return false;
+  }
+  AwaitNode* waiter = pop_locked(msg);
+  lock.unlock();
+  resume(waiter);
+  return true;
+}
+
+// Blocks until at least one message is available, then moves up to max of
+// them into out under a single lock. Returns 0 only at end of stream, so
+// max must be at least one.
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::pop_bulk(std::vector<T>& out, size_t max) {
+  if (max == 0) {
+    throw std::invalid_argument(ERROR_BULK_SIZE);
+  }
+  WaiterList woken;
+  std::unique_lock<MutexType> lock(mtx_);
+  not_empty_.wait(lock, [this] () {return closed_ || count_ != 0;});
+  size_t taken = pop_bulk_locked(out, max, woken);
+  lock.unlock();
+  resume_all(woken.head);
+  return taken;
+}
+
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::try_pop_bulk(std::vector<T>& out, size_t max) {
+  WaiterList woken;
+  std::unique_lock<MutexType> lock(mtx_);
+  size_t taken = pop_bulk_locked(out, max, woken);
+  lock.unlock();
+  resume_all(woken.head);
+  return taken;
+}
+
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::pop_bulk_locked(std::vector<T>& out, size_t max, WaiterList& woken) {
+  size_t taken = std::min(max, count_);
+  out.reserve(out.size() + taken);
+  for (size_t i = 0; i < taken; ++i) {
+    out.emplace_back();
+    if (AwaitNode* waiter = pop_locked(out.back())) {
+      woken.push_back(waiter);
+    }
+  }
+  return taken;
+}
+
+template <typename T, typename Policy>
+void RingBuffer<T, Policy>::close() {
+  AwaitNode* pop_waiters;
+  AwaitNode* push_waiters;
+  {
+    std::scoped_lock<MutexType> lock(mtx_);
+    closed_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+    pop_waiters = pop_waiters_.take_all();
+    push_waiters = push_waiters_.take_all();
+  }
+  resume_all(pop_waiters);
+  resume_all(push_waiters);
+}
+
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::closed() const {
+  return closed_.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Policy>
+void RingBuffer<T, Policy>::set_watermarks(size_t low, size_t high, PressureCallback on_change) {
+  std::scoped_lock<MutexType> lock(mtx_);
+  if (low > high || high > capacity_ - 1) {
+    throw std::invalid_argument(ERROR_WATERMARKS);
+  }
+  low_mark_ = low;
+  high_mark_ = high;
+  on_pressure_ = std::move(on_change);
+  level_ = level_for(count_, low, high, capacity_ - 1);
+}
+
+template <typename T, typename Policy>
+PressureLevel RingBuffer<T, Policy>::pressure() const {
+  return level_for(fill_.load(std::memory_order_relaxed), low_mark_.load(std::memory_order_relaxed),
+                   high_mark_.load(std::memory_order_relaxed), capacity_ - 1);
+}
+
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::low_watermark() const {
+  return low_mark_.load(std::memory_order_relaxed);
+}
+
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::high_watermark() const {
+  return high_mark_.load(std::memory_order_relaxed);
+}
+
+template <typename T, typename Policy>
+double RingBuffer<T, Policy>::fill_ratio() const {
+  return static_cast<double>(fill_.load(std::memory_order_relaxed)) / (capacity_ - 1);
+}
+
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::PopAwaiter RingBuffer<T, Policy>::async_pop(Executor& executor) {
+  return PopAwaiter(*this, executor);
+}
+
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::PushAwaiter RingBuffer<T, Policy>::async_push(const T& msg, Executor& executor) {
+  return PushAwaiter(*this, msg, executor);
+}
+
+// The getters below read only constants and the atomic fill_/closed_
+// mirrors, so they never take the lock and cannot contend with push/pop.
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::capacity() const {
   return capacity_ - 1;
 }
 
-template <typename T>
-size_t RingBuffer<T>::size() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
-  return count_;
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::size() const {
+  return fill_.load(std::memory_order_acquire);
 }
 
-template <typename T>
-size_t RingBuffer<T>::available() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
-  return (capacity_ - 1) - count_;
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::available() const {
+  return (capacity_ - 1) - size();
 }
 
-template <typename T>
-bool RingBuffer<T>::full() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
-  return (back_ + 1) % capacity_ == front_;
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::full() const {
+  return size() == capacity_ - 1;
 }
 
-template <typename T>
-bool RingBuffer<T>::empty() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
-  return front_ == back_;
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::empty() const {
+  return size() == 0;
 }
 
-template <typename T>
-void RingBuffer<T>::show() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
+template <typename T, typename Policy>
+void RingBuffer<T, Policy>::show() const {
+  std::scoped_lock<MutexType> lock(mtx_);
   for (size_t i = front_; i != back_; i = (i + 1) % capacity_) {
     std::cout << buffer_[i] << ' ';
   }
   std::cout << '\n';
 }
 
-template <typename T>
-std::tuple<size_t, size_t, size_t> RingBuffer<T>::snapshot() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
-  return {count_, (capacity_ - 1) - count_, capacity_ - 1};
+template <typename T, typename Policy>
+std::tuple<size_t, size_t, size_t> RingBuffer<T, Policy>::snapshot() const {
+  const size_t count = size();
+  return {count, (capacity_ - 1) - count, capacity_ - 1};
 }
 
-template <typename T>
-RingBuffer<T>::Iterator RingBuffer<T>::begin() {
-  std::scoped_lock<std::mutex> lock(mtx_);
+// Appends the current contents, oldest first, without consuming them. The
+// copy is taken under one lock, so it is a consistent point-in-time view.
+template <typename T, typename Policy>
+size_t RingBuffer<T, Policy>::copy_to(std::vector<T>& out) const {
+  std::scoped_lock<MutexType> lock(mtx_);
+  out.reserve(out.size() + count_);
+  for (size_t i = 0, pos = front_; i < count_; ++i, pos = (pos + 1) % capacity_) {
+    out.push_back(buffer_[pos]);
+  }
+  return count_;
+}
+
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::Iterator RingBuffer<T, Policy>::begin() {
+  std::scoped_lock<MutexType> lock(mtx_);
 	return Iterator(buffer_, front_, count_, capacity_);
 };
 
-template <typename T>
-RingBuffer<T>::Iterator RingBuffer<T>::end() {
-  std::scoped_lock<std::mutex> lock(mtx_);
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::Iterator RingBuffer<T, Policy>::end() {
+  std::scoped_lock<MutexType> lock(mtx_);
 	return Iterator(buffer_, back_, 0, capacity_);
 };
 
-template <typename T>
-RingBuffer<T>::ConstIterator RingBuffer<T>::cbegin() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::ConstIterator RingBuffer<T, Policy>::cbegin() const {
+  std::scoped_lock<MutexType> lock(mtx_);
 	return ConstIterator(buffer_, front_, count_, capacity_);
 };
 
-template <typename T>
-RingBuffer<T>::ConstIterator RingBuffer<T>::cend() const {
-  std::scoped_lock<std::mutex> lock(mtx_);
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::ConstIterator RingBuffer<T, Policy>::cend() const {
+  std::scoped_lock<MutexType> lock(mtx_);
 	return ConstIterator(buffer_, back_, 0, capacity_);
 };
 
+//PopAwaiter
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::PopAwaiter::PopAwaiter(RingBuffer& ring, Executor& executor) : ring_(ring) {
+  this->executor = &executor;
+}
+
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::PopAwaiter::await_ready() const noexcept {
+  return false;
+}
+
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::PopAwaiter::await_suspend(std::coroutine_handle<> handle) {
+  std::unique_lock<MutexType> lock(ring_.mtx_);
+  if (ring_.count_ != 0) {
+    T msg;
+    AwaitNode* waiter = ring_.pop_locked(msg);
+    result_ = std::move(msg);
+    lock.unlock();
+    resume(waiter);
+    return false;
+  }
+  if (ring_.closed_) {
+    return false;
+  }
+  this->handle = handle;
+  ring_.pop_waiters_.push_back(this);
+  return true;
+}
+
+// std::nullopt means the buffer was closed and fully drained.
+template <typename T, typename Policy>
+std::optional<T> RingBuffer<T, Policy>::PopAwaiter::await_resume() {
+  return std::move(result_);
+}
+
+//PushAwaiter
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::PushAwaiter::PushAwaiter(RingBuffer& ring, const T& msg, Executor& executor) : ring_(ring), msg_(msg) {
+  this->executor = &executor;
+}
+
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::PushAwaiter::await_ready() const noexcept {
+  return false;
+}
+
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::PushAwaiter::await_suspend(std::coroutine_handle<> handle) {
+  std::unique_lock<MutexType> lock(ring_.mtx_);
+  if (ring_.closed_) {
+    return false;
+  }
+  if (ring_.count_ < ring_.capacity_ - 1) {
+    AwaitNode* waiter = ring_.push_locked(msg_);
+    ok_ = true;
+    lock.unlock();
+    resume(waiter);
+    return false;
+  }
+  this->handle = handle;
+  ring_.push_waiters_.push_back(this);
+  return true;
+}
+
+// false means the buffer was closed before the message was accepted.
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::PushAwaiter::await_resume() const noexcept {
+  return ok_;
+}
+
 //Iterator
-template <typename T>
-RingBuffer<T>::Iterator::Iterator(std::vector<T>& buffer, size_t pos, size_t count, size_t capacity) : buffer_(buffer), pos_(pos), count_(count), capacity_(capacity) {}
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::Iterator::Iterator(std::vector<T>& buffer, size_t pos, size_t count, size_t capacity) : buffer_(buffer), pos_(pos), count_(count), capacity_(capacity) {}
 
-template <typename T>
-RingBuffer<T>::Iterator::reference RingBuffer<T>::Iterator::operator*() {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::Iterator::reference RingBuffer<T, Policy>::Iterator::operator*() {
   return buffer_[pos_];
 }
 
-template <typename T>
-RingBuffer<T>::Iterator::pointer RingBuffer<T>::Iterator::operator->() {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::Iterator::pointer RingBuffer<T, Policy>::Iterator::operator->() {
 	return &buffer_[pos_];
 }
 
-template <typename T>
-RingBuffer<T>::Iterator& RingBuffer<T>::Iterator::operator++() {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::Iterator& RingBuffer<T, Policy>::Iterator::operator++() {
 	if (count_ > 0) {
 		pos_ = (pos_ + 1) % capacity_;
 		--count_;
@@ -253,39 +676,39 @@ RingBuffer<T>::Iterator& RingBuffer<T>::Iterator::operator++() {
 	return *this;
 }
 
-template <typename T>
-RingBuffer<T>::Iterator RingBuffer<T>::Iterator::operator++(int) {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::Iterator RingBuffer<T, Policy>::Iterator::operator++(int) {
 	Iterator tmp = *this;
 	++(*this);
 	return tmp;
 }
 
-template <typename T>
-bool RingBuffer<T>::Iterator::operator==(const Iterator& other) const {
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::Iterator::operator==(const Iterator& other) const {
 	return &buffer_ == &other.buffer_ && count_ == other.count_ && pos_ == other.pos_;
 }
 
-template <typename T>
-bool RingBuffer<T>::Iterator::operator!=(const Iterator& other) const {
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::Iterator::operator!=(const Iterator& other) const {
   return !(*this == other);
 }
 
 //ConstIterator
-template <typename T>
-RingBuffer<T>::ConstIterator::ConstIterator(const std::vector<T>& buffer, size_t pos, size_t count, size_t capacity) : buffer_(buffer), pos_(pos), count_(count), capacity_(capacity) {}
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::ConstIterator::ConstIterator(const std::vector<T>& buffer, size_t pos, size_t count, size_t capacity) : buffer_(buffer), pos_(pos), count_(count), capacity_(capacity) {}
 
-template <typename T>
-RingBuffer<T>::ConstIterator::reference RingBuffer<T>::ConstIterator::operator*() const {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::ConstIterator::reference RingBuffer<T, Policy>::ConstIterator::operator*() const {
   return buffer_[pos_];
 }
 
-template <typename T>
-RingBuffer<T>::ConstIterator::pointer RingBuffer<T>::ConstIterator::operator->() const {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::ConstIterator::pointer RingBuffer<T, Policy>::ConstIterator::operator->() const {
 	return &buffer_[pos_];
 }
 
-template <typename T>
-RingBuffer<T>::ConstIterator& RingBuffer<T>::ConstIterator::operator++() {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::ConstIterator& RingBuffer<T, Policy>::ConstIterator::operator++() {
 	if (count_ > 0) {
 		pos_ = (pos_ + 1) % capacity_;
 		--count_;
@@ -293,20 +716,20 @@ RingBuffer<T>::ConstIterator& RingBuffer<T>::ConstIterator::operator++() {
 	return *this;
 }
 
-template <typename T>
-RingBuffer<T>::ConstIterator RingBuffer<T>::ConstIterator::operator++(int) {
+template <typename T, typename Policy>
+RingBuffer<T, Policy>::ConstIterator RingBuffer<T, Policy>::ConstIterator::operator++(int) {
 	ConstIterator tmp = *this;
 	++(*this);
 	return tmp;
 }
 
-template <typename T>
-bool RingBuffer<T>::ConstIterator::operator==(const ConstIterator& other) const {
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::ConstIterator::operator==(const ConstIterator& other) const {
 	return &buffer_ == &other.buffer_ && count_ == other.count_ && pos_ == other.pos_;
 }
 
-template <typename T>
-bool RingBuffer<T>::ConstIterator::operator!=(const ConstIterator& other) const {
+template <typename T, typename Policy>
+bool RingBuffer<T, Policy>::ConstIterator::operator!=(const ConstIterator& other) const {
   return !(*this == other);
 }
 
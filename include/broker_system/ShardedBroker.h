@@ -0,0 +1,279 @@
+#ifndef SHARDEDBROKER_H
+#define SHARDEDBROKER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <broker_system/SpscRing.h>
+
+#define ERROR_SHARDS "ShardedBroker needs at least one shard and a handler"
+
+// Pins the calling thread to one CPU; false if the OS refused.
+bool pin_current_thread(size_t cpu);
+// CPUs this process may run on (sched_getaffinity), so taskset and cgroup
+// cpusets are honoured. Never empty.
+std::vector<size_t> allowed_cpus();
+
+struct ShardedBrokerOptions {
+  size_t shards = allowed_cpus().size();
+  size_t channel_capacity = 4096;
+  size_t batch_size = 64;
+  bool pin_threads = true;
+  std::vector<size_t> cpus;  // shard -> cpu, defaults to the allowed CPUs in turn
+};
+
+// Shard-per-core broker. Every shard owns one consumer thread pinned to its
+// CPU and one producer slot. A message published by shard i for shard j
+// travels through the dedicated SpscRing channel (i, j), so no lock or
+// cache line is shared by more than one writer. Each consumer allocates its
+// inbound channels after pinning itself, which places them on its local
+// NUMA node through first-touch allocation. A thread that could not be
+// pinned keeps running unpinned and is counted in pin_failures().
+template <typename T>
+class ShardedBroker {
+ public:
+  using Handler = std::function<void(const T& msg, size_t shard)>;
+  using Router = std::function<size_t(const T& msg)>;
+
+  class Producer {
+   public:
+    bool publish(const T& msg);
+    size_t shard() const;
+
+   private:
+    friend class ShardedBroker;
+    Producer(ShardedBroker& broker, size_t shard);
+
+    ShardedBroker& broker_;
+    size_t shard_;
+  };
+
+  ShardedBroker(Handler handler, Router router, ShardedBrokerOptions options = {});
+  ~ShardedBroker();
+
+  ShardedBroker(const ShardedBroker&) = delete;
+  ShardedBroker& operator=(const ShardedBroker&) = delete;
+
+  Producer producer(size_t shard);
+  void run_producer(size_t shard, std::function<void(Producer&)> body);
+  void stop();
+
+  size_t shards() const;
+  size_t cpu_of(size_t shard) const;
+  uint64_t processed(size_t shard) const;
+  uint64_t processed() const;
+  uint64_t pin_failures() const;
+
+ private:
+  // processed is written by the shard's consumer, publishing by the thread
+  // publishing for the shard; each on its own cache line.
+  struct ShardState {
+    alignas(kCacheLineSize) std::atomic<uint64_t> processed{0};
+    alignas(kCacheLineSize) std::atomic<uint64_t> publishing{0};
+  };
+
+  SpscRing<T>& channel(size_t from, size_t to);
+  void pin(size_t shard);
+  void consume(size_t shard);
+  bool quiescent() const;
+
+  Handler handler_;
+  Router router_;
+  ShardedBrokerOptions options_;
+  std::vector<std::unique_ptr<SpscRing<T>>> channels_;
+  std::vector<ShardState> state_;
+  std::vector<std::thread> consumers_;
+  std::vector<std::thread> producers_;
+  std::latch ready_;
+  std::atomic<bool> stopping_{false};
+  std::atomic<uint64_t> pin_failures_{0};
+};
+
+template <typename T>
+ShardedBroker<T>::ShardedBroker(Handler handler, Router router, ShardedBrokerOptions options)
+    : handler_(std::move(handler)),
+      router_(std::move(router)),
+      options_(std::move(options)),
+      channels_(options_.shards * options_.shards),
+      state_(options_.shards),
+      ready_(static_cast<std::ptrdiff_t>(options_.shards)) {
+  if (options_.shards == 0 || !handler_) {
+    throw std::invalid_argument(ERROR_SHARDS);
+  }
+  if (options_.cpus.size() < options_.shards) {
+    const std::vector<size_t> allowed = allowed_cpus();
+    for (size_t shard = options_.cpus.size(); shard < options_.shards; ++shard) {
+      options_.cpus.push_back(allowed[shard % allowed.size()]);
+    }
+  }
+  for (size_t shard = 0; shard < options_.shards; ++shard) {
+    consumers_.emplace_back(&ShardedBroker::consume, this, shard);
+  }
+  ready_.wait();
+}
+
+template <typename T>
+ShardedBroker<T>::~ShardedBroker() {
+  stop();
+}
+
+template <typename T>
+ShardedBroker<T>::Producer ShardedBroker<T>::producer(size_t shard) {
+  return Producer(*this, shard % options_.shards);
+}
+
+// Runs body on a new thread pinned next to the shard's consumer.
+template <typename T>
+void ShardedBroker<T>::run_producer(size_t shard, std::function<void(Producer&)> body) {
+  producers_.emplace_back([this, shard, body = std::move(body)]() {
+    Producer producer(*this, shard % options_.shards);
+    pin(producer.shard());
+    body(producer);
+  });
+}
+
+// Waits for run_producer threads, then lets consumers drain their channels.
+// A publish() racing stop() either fails or is delivered before the
+// consumers exit, never lost.
+template <typename T>
+void ShardedBroker<T>::stop() {
+  for (auto& thread : producers_) {
+    if (thread.joinable()) thread.join();
+  }
+  stopping_.store(true);
+  for (auto& thread : consumers_) {
+    if (thread.joinable()) thread.join();
+  }
+}
+
+template <typename T>
+size_t ShardedBroker<T>::shards() const {
+  return options_.shards;
+}
+
+template <typename T>
+size_t ShardedBroker<T>::cpu_of(size_t shard) const {
+  return options_.cpus.at(shard);
+}
+
+template <typename T>
+uint64_t ShardedBroker<T>::processed(size_t shard) const {
+  return state_.at(shard).processed.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+uint64_t ShardedBroker<T>::processed() const {
+  uint64_t total = 0;
+  for (auto& state : state_) total += state.processed.load(std::memory_order_relaxed);
+  return total;
+}
+
+template <typename T>
+uint64_t ShardedBroker<T>::pin_failures() const {
+  return pin_failures_.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+SpscRing<T>& ShardedBroker<T>::channel(size_t from, size_t to) {
+  return *channels_[from * options_.shards + to];
+}
+
+template <typename T>
+void ShardedBroker<T>::pin(size_t shard) {
+  if (options_.pin_threads && !pin_current_thread(cpu_of(shard))) {
+    pin_failures_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// True once stop() was called and no publish() is still in flight. Pairs
+// with the seq_cst increment and stopping_ check in publish(): either the
+// publisher sees stopping_ and backs off, or this sees it publishing.
+template <typename T>
+bool ShardedBroker<T>::quiescent() const {
+  if (!stopping_.load()) {
+    return false;
+  }
+  for (auto& state : state_) {
+    if (state.publishing.load() != 0) return false;
+  }
+  return true;
+}
+
+template <typename T>
+void ShardedBroker<T>::consume(size_t shard) {
+  pin(shard);
+  for (size_t from = 0; from < options_.shards; ++from) {
+    channels_[from * options_.shards + shard] = std::make_unique<SpscRing<T>>(options_.channel_capacity);
+  }
+  ready_.count_down();
+
+  std::atomic<uint64_t>& processed = state_[shard].processed;
+  size_t idle = 0;
+  T msg;
+  while (true) {
+    size_t handled = 0;
+    for (size_t from = 0; from < options_.shards; ++from) {
+      SpscRing<T>& inbound = channel(from, shard);
+      for (size_t i = 0; i < options_.batch_size && inbound.try_pop(msg); ++i) {
+        handler_(msg, shard);
+        ++handled;
+      }
+    }
+    if (handled != 0) {
+      processed.fetch_add(handled, std::memory_order_relaxed);
+      idle = 0;
+      continue;
+    }
+    if (quiescent()) {
+      bool drained = true;
+      for (size_t from = 0; from < options_.shards; ++from) {
+        drained = drained && channel(from, shard).empty();
+      }
+      if (drained) return;
+    }
+    if (++idle < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+}
+
+// Producer
+template <typename T>
+ShardedBroker<T>::Producer::Producer(ShardedBroker& broker, size_t shard) : broker_(broker), shard_(shard) {}
+
+// Only one thread may publish through a given shard's producer at a time:
+// it is the single writer of that shard's outbound channels. Returns false
+// once stop() has begun. A full channel keeps the consumers alive until the
+// message fits, so the retry loop always ends.
+template <typename T>
+bool ShardedBroker<T>::Producer::publish(const T& msg) {
+  std::atomic<uint64_t>& publishing = broker_.state_[shard_].publishing;
+  publishing.fetch_add(1);
+  if (broker_.stopping_.load()) {
+    publishing.fetch_sub(1, std::memory_order_release);
+    return false;
+  }
+  size_t target = broker_.router_ ? broker_.router_(msg) % broker_.options_.shards : shard_;
+  SpscRing<T>& outbound = broker_.channel(shard_, target);
+  while (!outbound.try_push(msg)) {
+    std::this_thread::yield();
+  }
+  publishing.fetch_sub(1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+size_t ShardedBroker<T>::Producer::shard() const {
+  return shard_;
+}
+
+#endif
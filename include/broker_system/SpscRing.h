@@ -0,0 +1,105 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#define ERROR_SPSC_SIZE "SpscRing capacity must be greater than 0"
+
+constexpr size_t kCacheLineSize = 64;
+
+// Lock-free ring for exactly one producer thread and one consumer thread.
+// Indices grow monotonically and are masked into a power-of-two buffer, so
+// the whole requested capacity is usable (no shadow cell as in RingBuffer).
+template <typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(size_t capacity);
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  bool try_push(const T& msg);
+  bool try_pop(T& msg);
+  size_t size() const;
+  size_t capacity() const;
+  bool empty() const;
+
+ private:
+  static size_t round_up_pow2(size_t n);
+
+  std::vector<T> buffer_;
+  size_t mask_;
+
+  alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+  size_t cached_tail_ = 0;
+
+  alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+  size_t cached_head_ = 0;
+};
+
+template <typename T>
+SpscRing<T>::SpscRing(size_t capacity) {
+  if (capacity < 1) {
+    throw std::invalid_argument(ERROR_SPSC_SIZE);
+  }
+  buffer_.resize(round_up_pow2(capacity));
+  mask_ = buffer_.size() - 1;
+}
+
+template <typename T>
+size_t SpscRing<T>::round_up_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+template <typename T>
+bool SpscRing<T>::try_push(const T& msg) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - cached_head_ > mask_) {
+    cached_head_ = head_.load(std::memory_order_acquire);
+    if (tail - cached_head_ > mask_) {
+      return false;
+    }
+  }
+  buffer_[tail & mask_] = msg;
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool SpscRing<T>::try_pop(T& msg) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  if (head == cached_tail_) {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    if (head == cached_tail_) {
+      return false;
+    }
+  }
+  msg = buffer_[head & mask_];
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+size_t SpscRing<T>::size() const {
+  const size_t head = head_.load(std::memory_order_acquire);
+  const size_t tail = tail_.load(std::memory_order_acquire);
+  return tail - head;
+}
+
+template <typename T>
+size_t SpscRing<T>::capacity() const {
+  return mask_ + 1;
+}
+
+template <typename T>
+bool SpscRing<T>::empty() const {
+  return size() == 0;
+}
+
+#endif
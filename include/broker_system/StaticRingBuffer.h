@@ -0,0 +1,109 @@
+#ifndef STATICRINGBUFFER_H
+#define STATICRINGBUFFER_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+
+// Ring with a capacity fixed at compile time and inline std::array storage:
+// no heap allocation, no locking, and capacity and mask are constants the
+// compiler folds into every index computation. Meant for single-threaded
+// fast paths (per-thread staging, small lookahead windows); every operation
+// is constexpr, so the ring is also usable in constant expressions.
+//
+// N must be a power of two. Indices grow monotonically and are masked, so
+// all N cells are usable (no shadow cell as in RingBuffer).
+template <typename T, size_t N>
+class StaticRingBuffer {
+  static_assert(N > 0 && std::has_single_bit(N), "StaticRingBuffer capacity must be a power of two");
+
+ public:
+  static constexpr size_t kCapacity = N;
+  static constexpr size_t kMask = N - 1;
+
+  constexpr bool try_push(const T& msg);
+  constexpr bool try_pop(T& msg);
+  constexpr T& front();
+  constexpr const T& front() const;
+  constexpr T& operator[](size_t i);
+  constexpr const T& operator[](size_t i) const;
+  constexpr void clear();
+
+  constexpr bool full() const;
+  constexpr bool empty() const;
+  constexpr size_t size() const;
+  constexpr size_t available() const;
+  static constexpr size_t capacity() { return N; }
+
+ private:
+  std::array<T, N> buffer_{};
+  size_t head_ = 0;
+  size_t tail_ = 0;
+};
+
+template <typename T, size_t N>
+constexpr bool StaticRingBuffer<T, N>::try_push(const T& msg) {
+  if (full()) {
+    return false;
+  }
+  buffer_[tail_++ & kMask] = msg;
+  return true;
+}
+
+template <typename T, size_t N>
+constexpr bool StaticRingBuffer<T, N>::try_pop(T& msg) {
+  if (empty()) {
+    return false;
+  }
+  msg = buffer_[head_++ & kMask];
+  return true;
+}
+
+// front() and operator[] require a non-empty ring / i < size().
+template <typename T, size_t N>
+constexpr T& StaticRingBuffer<T, N>::front() {
+  return buffer_[head_ & kMask];
+}
+
+template <typename T, size_t N>
+constexpr const T& StaticRingBuffer<T, N>::front() const {
+  return buffer_[head_ & kMask];
+}
+
+// Element i counted from the oldest one.
+template <typename T, size_t N>
+constexpr T& StaticRingBuffer<T, N>::operator[](size_t i) {
+  return buffer_[(head_ + i) & kMask];
+}
+
+template <typename T, size_t N>
+constexpr const T& StaticRingBuffer<T, N>::operator[](size_t i) const {
+  return buffer_[(head_ + i) & kMask];
+}
+
+template <typename T, size_t N>
+constexpr void StaticRingBuffer<T, N>::clear() {
+  head_ = tail_;
+}
+
+template <typename T, size_t N>
+constexpr bool StaticRingBuffer<T, N>::full() const {
+  return tail_ - head_ == N;
+}
+
+template <typename T, size_t N>
+constexpr bool StaticRingBuffer<T, N>::empty() const {
+  return tail_ == head_;
+}
+
+template <typename T, size_t N>
+constexpr size_t StaticRingBuffer<T, N>::size() const {
+  return tail_ - head_;
+}
+
+template <typename T, size_t N>
+constexpr size_t StaticRingBuffer<T, N>::available() const {
+  return N - size();
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef SUBSCRIPTIONROUTER_H
+#define SUBSCRIPTIONROUTER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+#include <broker_system/VideoEvent.h>
+
+#define ERROR_ROUTER_BATCH "SubscriptionRouter::run needs a batch size of at least one"
+
+constexpr uint8_t type_bit(EventType type) {
+  return static_cast<uint8_t>(1u << static_cast<uint8_t>(type));
+}
+
+constexpr uint8_t kAllEventTypes = (1u << kEventTypeCount) - 1;
+
+// Predicate of a filtered subscription. An event matches when its type bit
+// is in type_mask, video_min <= video_id <= video_max, and its creator is
+// the given one (any creator if unset).
+struct EventFilter {
+  uint8_t type_mask = kAllEventTypes;
+  uint32_t video_min = 0;
+  uint32_t video_max = UINT32_MAX;
+  std::optional<uint8_t> creator;
+
+  bool matches(const VideoEvent& event) const;
+};
+
+// Compact struct-of-arrays copy of the fields a filter looks at, built once
+// per batch and shared by every subscription. The type is stored one-hot so
+// a type mask test is a single AND.
+struct EventHeaders {
+  std::vector<uint32_t> video_id;
+  std::vector<uint8_t> type_bit;
+  std::vector<uint8_t> creator_id;
+
+  void build(const VideoEvent* events, size_t n);
+  size_t size() const;
+};
+
+// mask[i] becomes non-zero iff headers row i matches filter. Scans 16 rows
+// per step with SSE2 when available.
+void match_headers(const EventHeaders& headers, const EventFilter& filter, uint8_t* mask);
+
+// Broker-side fan-out with predicate pushdown: every routed batch is
+// matched against each subscription's filter, and only matching events are
+// pushed into that subscriber's RingBuffer, so a consumer interested in
+// likes never dequeues views. A full subscriber queue is waited on for at
+// most push_timeout per batch; matches that still do not fit are dropped,
+// so one slow subscriber cannot stall delivery to the others. Routing runs
+// on a single thread; subscribe() must not race route() or run(). The
+// counters may be read from any thread.
+class SubscriptionRouter {
+ public:
+  explicit SubscriptionRouter(std::chrono::milliseconds push_timeout = std::chrono::milliseconds(100));
+
+  size_t subscribe(const EventFilter& filter, RingBuffer<VideoEvent>& queue);
+
+  size_t route(const VideoEvent* events, size_t n);
+  size_t route(const std::vector<VideoEvent>& batch);
+  void run(RingBuffer<VideoEvent>& source, size_t batch_size);
+
+  size_t subscribers() const;
+  uint64_t delivered(size_t subscription) const;
+  uint64_t filtered(size_t subscription) const;
+  uint64_t dropped(size_t subscription) const;
+
+ private:
+  // Every routed event ends up in exactly one of delivered, filtered
+  // (predicate rejected it) or dropped (queue full past the timeout, or
+  // closed).
+  struct Subscription {
+    Subscription(const EventFilter& filter, RingBuffer<VideoEvent>& queue) : filter(filter), queue(&queue) {}
+
+    EventFilter filter;
+    RingBuffer<VideoEvent>* queue;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> filtered{0};
+    std::atomic<uint64_t> dropped{0};
+    bool open = true;
+  };
+
+  std::chrono::milliseconds push_timeout_;
+  std::vector<std::unique_ptr<Subscription>> subscriptions_;
+  EventHeaders headers_;
+  std::vector<uint8_t> mask_;
+};
+
+#endif
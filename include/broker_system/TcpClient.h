@@ -0,0 +1,37 @@
+#ifndef TCPCLIENT_H
+#define TCPCLIENT_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <sys/types.h>
+
+// Minimal blocking TCP client used by the services that talk to the outside
+// world (Redis logging, loopback producers).
+class TcpClient {
+ public:
+  TcpClient() = default;
+  ~TcpClient();
+
+  TcpClient(const TcpClient&) = delete;
+  TcpClient& operator=(const TcpClient&) = delete;
+
+  // Bounds every later connect, send and receive (SO_SNDTIMEO /
+  // SO_RCVTIMEO); zero blocks forever. A timed-out call closes the connection, because the
+  // request/reply stream is out of step afterwards.
+  void set_timeout(std::chrono::milliseconds timeout);
+  bool connect(const std::string& host, uint16_t port);
+  bool send_all(std::string_view data);
+  ssize_t recv_some(char* buf, size_t len);
+  bool connected() const;
+  void close();
+
+ private:
+  int fd_ = -1;
+  std::chrono::milliseconds timeout_{0};
+};
+
+#endif
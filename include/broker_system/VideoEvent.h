@@ -0,0 +1,35 @@
+#ifndef VIDEOEVENT_H
+#define VIDEOEVENT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Workload dimensions of the simulated video platform (see README).
+constexpr uint32_t kVideoCount = 1000;
+constexpr uint32_t kCreatorCount = 10;
+constexpr uint32_t kUserCount = 1000000;
+
+enum class EventType : uint8_t { View, Like, Dislike, Comment, WatchDuration };
+
+constexpr size_t kEventTypeCount = 5;
+
+// Metadata event emitted by producers for one user action. IDs are dense:
+// video_id < kVideoCount, creator_id < kCreatorCount. Every producer numbers
+// its events 1, 2, 3... so the broker can drop retried duplicates;
+// sequence 0 means the event is not sequenced.
+struct VideoEvent {
+  uint64_t timestamp_ms = 0;
+  uint64_t sequence = 0;
+  uint32_t producer_id = 0;
+  uint32_t user_id = 0;
+  uint32_t video_id = 0;
+  uint32_t watch_ms = 0;
+  uint8_t creator_id = 0;
+  EventType type = EventType::View;
+};
+
+constexpr uint8_t creator_of(uint32_t video_id) {
+  return static_cast<uint8_t>(video_id % kCreatorCount);
+}
+
+#endif
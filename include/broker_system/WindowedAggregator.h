@@ -0,0 +1,134 @@
+#ifndef WINDOWEDAGGREGATOR_H
+#define WINDOWEDAGGREGATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+#include <broker_system/VideoEvent.h>
+
+#define ERROR_WINDOW_SIZE "Window and slide must be > 0 and window a multiple of slide"
+
+// Struct-of-arrays counters indexed by a dense key (video or creator id).
+// Whole-block add/sub are plain element loops the compiler vectorizes.
+template <size_t N>
+struct CounterBlock {
+  alignas(64) std::array<uint64_t, N> views{};
+  alignas(64) std::array<uint64_t, N> likes{};
+  alignas(64) std::array<uint64_t, N> dislikes{};
+  alignas(64) std::array<uint64_t, N> comments{};
+  alignas(64) std::array<uint64_t, N> watch_count{};
+  alignas(64) std::array<uint64_t, N> watch_ms{};
+
+  void record(size_t key, const VideoEvent& event);
+  void add(const CounterBlock& other);
+  void sub(const CounterBlock& other);
+  void clear();
+};
+
+using VideoCounters = CounterBlock<kVideoCount>;
+using CreatorCounters = CounterBlock<kCreatorCount>;
+
+struct WindowResult {
+  uint64_t start_ms;
+  uint64_t end_ms;
+  uint64_t events;
+  const VideoCounters& videos;
+  const CreatorCounters& creators;
+};
+
+// Incremental tumbling/sliding window aggregation per video and per creator.
+// Time is cut into panes of slide_ms; a window covers window_ms / slide_ms
+// consecutive panes. Events only touch the open pane. When it closes, it is
+// added to the running window totals, the window is emitted, and the pane
+// that falls out of the window is subtracted, so history is never rescanned.
+// slide_ms == window_ms gives tumbling windows.
+class WindowedAggregator {
+ public:
+  using Callback = std::function<void(const WindowResult&)>;
+
+  WindowedAggregator(uint64_t window_ms, uint64_t slide_ms, Callback on_window);
+
+  void consume(const VideoEvent* events, size_t n);
+  void consume(const std::vector<VideoEvent>& batch);
+  void run(RingBuffer<VideoEvent>& source, size_t batch_size);
+  void flush();
+
+  uint64_t late_events() const;
+
+ private:
+  struct Pane {
+    VideoCounters videos;
+    CreatorCounters creators;
+    uint64_t events = 0;
+  };
+
+  void close_pane();
+
+  uint64_t window_ms_;
+  uint64_t slide_ms_;
+  Callback on_window_;
+  std::vector<Pane> panes_;
+  Pane totals_;
+  size_t head_ = 0;
+  uint64_t pane_start_ = 0;
+  bool started_ = false;
+  uint64_t late_ = 0;
+};
+
+template <size_t N>
+void CounterBlock<N>::record(size_t key, const VideoEvent& event) {
+  switch (event.type) {
+    case EventType::View:
+      ++views[key];
+      break;
+    case EventType::Like:
+      ++likes[key];
+      break;
+    case EventType::Dislike:
+      ++dislikes[key];
+      break;
+    case EventType::Comment:
+      ++comments[key];
+      break;
+    case EventType::WatchDuration:
+      ++watch_count[key];
+      watch_ms[key] += event.watch_ms;
+      break;
+  }
+}
+
+template <size_t N>
+void CounterBlock<N>::add(const CounterBlock& other) {
+  for (size_t i = 0; i < N; ++i) views[i] += other.views[i];
+  for (size_t i = 0; i < N; ++i) likes[i] += other.likes[i];
+  for (size_t i = 0; i < N; ++i) dislikes[i] += other.dislikes[i];
+  for (size_t i = 0; i < N; ++i) comments[i] += other.comments[i];
+  for (size_t i = 0; i < N; ++i) watch_count[i] += other.watch_count[i];
+  for (size_t i = 0; i < N; ++i) watch_ms[i] += other.watch_ms[i];
+}
+
+template <size_t N>
+void CounterBlock<N>::sub(const CounterBlock& other) {
+  for (size_t i = 0; i < N; ++i) views[i] -= other.views[i];
+  for (size_t i = 0; i < N; ++i) likes[i] -= other.likes[i];
+  for (size_t i = 0; i < N; ++i) dislikes[i] -= other.dislikes[i];
+  for (size_t i = 0; i < N; ++i) comments[i] -= other.comments[i];
+  for (size_t i = 0; i < N; ++i) watch_count[i] -= other.watch_count[i];
+  for (size_t i = 0; i < N; ++i) watch_ms[i] -= other.watch_ms[i];
+}
+
+template <size_t N>
+void CounterBlock<N>::clear() {
+  views.fill(0);
+  likes.fill(0);
+  dislikes.fill(0);
+  comments.fill(0);
+  watch_count.fill(0);
+  watch_ms.fill(0);
+}
+
+#endif
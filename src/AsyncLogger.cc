@@ -0,0 +1,271 @@
+#include <broker_system/AsyncLogger.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+std::atomic<uint64_t> next_logger_id{1};
+
+uint64_t now_us() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(system_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+const char* to_string(LogCategory category) {
+  switch (category) {
+    case LogCategory::Incoming:
+      return "incoming";
+    case LogCategory::Outgoing:
+      return "outgoing";
+    case LogCategory::Error:
+      return "error";
+    case LogCategory::Meta:
+      return "meta";
+  }
+  return "unknown";
+}
+
+void resp_append_command(std::string& out,
+                         std::initializer_list<std::string_view> args) {
+  out += '*';
+  out += std::to_string(args.size());
+  out += "\r\n";
+  for (std::string_view arg : args) {
+    out += '$';
+    out += std::to_string(arg.size());
+    out += "\r\n";
+    out.append(arg.data(), arg.size());
+    out += "\r\n";
+  }
+}
+
+// TcpRespSink
+TcpRespSink::TcpRespSink(std::string host, uint16_t port,
+                         std::chrono::milliseconds timeout)
+    : host_(std::move(host)), port_(port) {
+  client_.set_timeout(timeout);
+}
+
+size_t TcpRespSink::write(const std::string& payload, size_t commands) {
+  if (!client_.connected() && !client_.connect(host_, port_)) {
+    return 0;
+  }
+  if (!client_.send_all(payload)) {
+    return 0;
+  }
+  return read_replies(commands);
+}
+
+// RPUSH answers with a single-line integer or error per command. Returns
+// the number of replies that were not errors; a broken or timed-out
+// connection counts every unanswered command as failed.
+size_t TcpRespSink::read_replies(size_t commands) {
+  char buf[4096];
+  size_t accepted = 0;
+  bool line_start = true;
+  bool ok = false;
+  bool seen_cr = false;
+  while (commands > 0) {
+    ssize_t n = client_.recv_some(buf, sizeof(buf));
+    if (n <= 0) return accepted;
+    for (ssize_t i = 0; i < n && commands > 0; ++i) {
+      if (line_start) ok = buf[i] == '+' || buf[i] == ':';
+      line_start = seen_cr && buf[i] == '\n';
+      if (line_start) {
+        accepted += ok;
+        --commands;
+      }
+      seen_cr = buf[i] == '\r';
+    }
+  }
+  return accepted;
+}
+
+// AsyncLogger
+AsyncLogger::AsyncLogger(std::shared_ptr<RespSink> sink,
+                         AsyncLoggerOptions options)
+    : id_(next_logger_id.fetch_add(1, std::memory_order_relaxed)),
+      sink_(std::move(sink)),
+      options_(std::move(options)) {
+  options_.batch_size = std::max<size_t>(options_.batch_size, 1);
+  drainer_ = std::thread(&AsyncLogger::drain_loop, this);
+}
+
+AsyncLogger::~AsyncLogger() { stop(); }
+
+// Every entry pushed by the exiting thread happens-before the release
+// store, so the drainer sees them once it reads retired.
+AsyncLogger::RingCache::~RingCache() {
+  for (CachedRing& cached : entries) {
+    if (auto ring = cached.owner.lock()) {
+      ring->retired.store(true, std::memory_order_release);
+    }
+  }
+}
+
+AsyncLogger::ThreadRing& AsyncLogger::local_ring() {
+  thread_local RingCache cache;
+  for (CachedRing& cached : cache.entries) {
+    if (cached.logger_id == id_) return *cached.ring;
+  }
+
+  // Miss: drop the rings of loggers that were destroyed since.
+  std::erase_if(cache.entries, [](const CachedRing& cached) { return cached.owner.expired(); });
+  auto ring = std::make_shared<ThreadRing>(options_.ring_capacity);
+  {
+    std::scoped_lock<std::mutex> lock(rings_mtx_);
+    rings_.push_back(ring);
+  }
+  cache.entries.push_back(CachedRing{id_, ring, ring.get()});
+  return *ring;
+}
+
+// The seq_cst increment of logging before reading running_ pairs with
+// stop() clearing running_ before wait_for_loggers(): either log() sees the
+// logger stopping and backs off, or stop() waits for its push.
+bool AsyncLogger::log(LogCategory category, std::string_view text) {
+  ThreadRing& local = local_ring();
+  local.logging.fetch_add(1);
+  if (!running_.load()) {
+    local.logging.fetch_sub(1, std::memory_order_release);
+    local.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  LogEntry entry;
+  entry.timestamp_us = now_us();
+  entry.category = category;
+  entry.length = static_cast<uint8_t>(std::min(text.size(), kLogTextSize));
+  std::memcpy(entry.text, text.data(), entry.length);
+
+  bool pushed = local.ring.try_push(entry);
+  if (pushed) {
+    local.logged.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    local.dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+  local.logging.fetch_sub(1, std::memory_order_release);
+  return pushed;
+}
+
+void AsyncLogger::flush() {
+  std::scoped_lock<std::mutex> lock(drain_mtx_);
+  while (drain_once() != 0) {
+  }
+}
+
+void AsyncLogger::stop() {
+  if (!running_.exchange(false)) return;
+  wake_.notify_all();
+  if (drainer_.joinable()) drainer_.join();
+  wait_for_loggers();
+  flush();
+}
+
+// log() never blocks, so this only waits out pushes already under way.
+void AsyncLogger::wait_for_loggers() const {
+  std::scoped_lock<std::mutex> lock(rings_mtx_);
+  for (auto& ring : rings_) {
+    while (ring->logging.load() != 0) std::this_thread::yield();
+  }
+}
+
+void AsyncLogger::drain_loop() {
+  std::unique_lock<std::mutex> lock(drain_mtx_);
+  while (running_.load(std::memory_order_relaxed)) {
+    if (drain_once() == 0) {
+      wake_.wait_for(lock, options_.flush_interval);
+    }
+  }
+}
+
+// Frees the rings of exited threads once the drainer has emptied them,
+// keeping their counters. Only called by the single draining thread.
+void AsyncLogger::prune_retired() {
+  std::scoped_lock<std::mutex> lock(rings_mtx_);
+  std::erase_if(rings_, [this](const std::shared_ptr<ThreadRing>& ring) {
+    if (!ring->retired.load(std::memory_order_acquire) || !ring->ring.empty()) {
+      return false;
+    }
+    retired_logged_ += ring->logged.load(std::memory_order_relaxed);
+    retired_dropped_ += ring->dropped.load(std::memory_order_relaxed);
+    return true;
+  });
+}
+
+size_t AsyncLogger::drain_once() {
+  prune_retired();
+  std::vector<ThreadRing*> rings;
+  {
+    std::scoped_lock<std::mutex> lock(rings_mtx_);
+    rings.reserve(rings_.size());
+    for (auto& ring : rings_) rings.push_back(ring.get());
+  }
+
+  std::string payload;
+  size_t commands = 0;
+  size_t drained = 0;
+  std::string key;
+  std::string value;
+  LogEntry entry;
+
+  for (ThreadRing* ring : rings) {
+    size_t taken = 0;
+    while (taken < options_.batch_size && ring->ring.try_pop(entry)) {
+      key = options_.key_prefix;
+      key += to_string(entry.category);
+      value = std::to_string(entry.timestamp_us);
+      value += ' ';
+      value.append(entry.text, entry.length);
+      resp_append_command(payload, {"RPUSH", key, value});
+      ++taken;
+      if (++commands == options_.batch_size) send_batch(payload, commands);
+    }
+    drained += taken;
+  }
+  if (commands != 0) send_batch(payload, commands);
+  return drained;
+}
+
+void AsyncLogger::send_batch(std::string& payload, size_t& commands) {
+  size_t accepted = std::min(sink_->write(payload, commands), commands);
+  flushed_.fetch_add(accepted, std::memory_order_relaxed);
+  failed_.fetch_add(commands - accepted, std::memory_order_relaxed);
+  payload.clear();
+  commands = 0;
+}
+
+uint64_t AsyncLogger::logged() const {
+  std::scoped_lock<std::mutex> lock(rings_mtx_);
+  uint64_t total = retired_logged_;
+  for (auto& ring : rings_) {
+    total += ring->logged.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t AsyncLogger::dropped() const {
+  std::scoped_lock<std::mutex> lock(rings_mtx_);
+  uint64_t total = failed_.load(std::memory_order_relaxed) + retired_dropped_;
+  for (auto& ring : rings_) {
+    total += ring->dropped.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t AsyncLogger::flushed() const {
+  return flushed_.load(std::memory_order_relaxed);
+}
+
+uint64_t AsyncLogger::sink_dropped() const {
+  return failed_.load(std::memory_order_relaxed);
+}
+
+size_t AsyncLogger::rings() const {
+  std::scoped_lock<std::mutex> lock(rings_mtx_);
+  return rings_.size();
+}
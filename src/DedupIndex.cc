@@ -0,0 +1,52 @@
+#include <broker_system/DedupIndex.h>
+
+bool DedupIndex::accept(uint32_t producer_id, uint64_t sequence) {
+  Shard& shard = shards_[producer_id % kDedupShards];
+  std::scoped_lock<std::mutex> lock(shard.mtx);
+  ProducerState& state = shard.producers[producer_id];
+
+  if (sequence > state.high) {
+    const uint64_t shift = sequence - state.high;
+    state.window = shift >= kDedupWindow ? 0 : state.window << shift;
+    state.window |= 1;
+    state.high = sequence;
+    return true;
+  }
+
+  const uint64_t offset = state.high - sequence;
+  if (offset < kDedupWindow) {
+    const uint64_t bit = uint64_t{1} << offset;
+    if (!(state.window & bit)) {
+      state.window |= bit;
+      return true;
+    }
+  }
+  duplicates_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+// Undoes accept() for a sequence that never reached the broker. The
+// high-water mark stays, only the window bit is cleared.
+void DedupIndex::forget(uint32_t producer_id, uint64_t sequence) {
+  Shard& shard = shards_[producer_id % kDedupShards];
+  std::scoped_lock<std::mutex> lock(shard.mtx);
+  auto it = shard.producers.find(producer_id);
+  if (it == shard.producers.end() || sequence > it->second.high) {
+    return;
+  }
+  const uint64_t offset = it->second.high - sequence;
+  if (offset < kDedupWindow) {
+    it->second.window &= ~(uint64_t{1} << offset);
+  }
+}
+
+uint64_t DedupIndex::high_water_mark(uint32_t producer_id) const {
+  const Shard& shard = shards_[producer_id % kDedupShards];
+  std::scoped_lock<std::mutex> lock(shard.mtx);
+  auto it = shard.producers.find(producer_id);
+  return it == shard.producers.end() ? 0 : it->second.high;
+}
+
+uint64_t DedupIndex::duplicates() const {
+  return duplicates_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,342 @@
+#include <broker_system/EventSegment.h>
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef BROKER_HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef BROKER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+constexpr char kSegmentMagic[4] = {'B', 'K', 'S', 'G'};
+constexpr uint8_t kSegmentVersion = 1;
+constexpr size_t kBlockHeaderSize = 13;
+constexpr size_t kMaxBlockEvents = size_t{1} << 24;
+constexpr size_t kMaxEncodedEvent = 6 * 10 + 2;  // six varints + two bytes
+
+void put_u32(std::string& out, uint32_t value) {
+  for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+uint32_t get_u32(const char* in) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) value |= uint32_t{static_cast<uint8_t>(in[i])} << (8 * i);
+  return value;
+}
+
+void put_varint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+class Cursor {
+ public:
+  Cursor(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+  uint64_t varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (pos_ == end_) break;
+      uint8_t byte = static_cast<uint8_t>(*pos_++);
+      value |= uint64_t{byte & 0x7fu} << shift;
+      if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+  }
+
+  uint8_t byte() {
+    if (pos_ == end_) throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+    return static_cast<uint8_t>(*pos_++);
+  }
+
+  bool done() const { return pos_ == end_; }
+
+ private:
+  const char* pos_;
+  const char* end_;
+};
+
+// Column order: deltas of timestamp, sequence, producer and video, plain
+// user and watch time, then the creator and type bytes.
+template <typename Field>
+void put_delta_column(std::string& out, const std::vector<VideoEvent>& events, Field field) {
+  uint64_t prev = 0;
+  for (const VideoEvent& event : events) {
+    const uint64_t value = field(event);
+    put_varint(out, zigzag(static_cast<int64_t>(value - prev)));
+    prev = value;
+  }
+}
+
+template <typename Field>
+void put_plain_column(std::string& out, const std::vector<VideoEvent>& events, Field field) {
+  for (const VideoEvent& event : events) put_varint(out, field(event));
+}
+
+void encode_block(const std::vector<VideoEvent>& events, std::string& out) {
+  out.clear();
+  put_delta_column(out, events, [](const VideoEvent& e) { return e.timestamp_ms; });
+  put_delta_column(out, events, [](const VideoEvent& e) { return e.sequence; });
+  put_delta_column(out, events, [](const VideoEvent& e) { return uint64_t{e.producer_id}; });
+  put_delta_column(out, events, [](const VideoEvent& e) { return uint64_t{e.video_id}; });
+  put_plain_column(out, events, [](const VideoEvent& e) { return uint64_t{e.user_id}; });
+  put_plain_column(out, events, [](const VideoEvent& e) { return uint64_t{e.watch_ms}; });
+  for (const VideoEvent& e : events) out.push_back(static_cast<char>(e.creator_id));
+  for (const VideoEvent& e : events) out.push_back(static_cast<char>(e.type));
+}
+
+void decode_block(const std::string& in, size_t count, std::vector<VideoEvent>& out) {
+  out.assign(count, VideoEvent{});
+  Cursor cursor(in.data(), in.size());
+  uint64_t prev = 0;
+  for (auto& e : out) prev = e.timestamp_ms = prev + unzigzag(cursor.varint());
+  prev = 0;
+  for (auto& e : out) prev = e.sequence = prev + unzigzag(cursor.varint());
+  prev = 0;
+  for (auto& e : out) prev = e.producer_id = static_cast<uint32_t>(prev + unzigzag(cursor.varint()));
+  prev = 0;
+  for (auto& e : out) prev = e.video_id = static_cast<uint32_t>(prev + unzigzag(cursor.varint()));
+  for (auto& e : out) e.user_id = static_cast<uint32_t>(cursor.varint());
+  for (auto& e : out) e.watch_ms = static_cast<uint32_t>(cursor.varint());
+  for (auto& e : out) e.creator_id = cursor.byte();
+  for (auto& e : out) {
+    uint8_t type = cursor.byte();
+    if (type >= kEventTypeCount) throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+    e.type = static_cast<EventType>(type);
+  }
+  if (!cursor.done()) throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+}
+
+// Returns false when the codec did not shrink the block; it is then stored raw.
+bool compress(SegmentCodec codec, int level, const std::string& raw, std::string& out) {
+  switch (codec) {
+#ifdef BROKER_HAVE_LZ4
+    case SegmentCodec::Lz4: {
+      out.resize(LZ4_compressBound(static_cast<int>(raw.size())));
+      int n = LZ4_compress_default(raw.data(), out.data(), static_cast<int>(raw.size()),
+                                   static_cast<int>(out.size()));
+      out.resize(n > 0 ? n : 0);
+      return n > 0 && out.size() < raw.size();
+    }
+#endif
+#ifdef BROKER_HAVE_ZSTD
+    case SegmentCodec::Zstd: {
+      out.resize(ZSTD_compressBound(raw.size()));
+      size_t n = ZSTD_compress(out.data(), out.size(), raw.data(), raw.size(), level);
+      if (ZSTD_isError(n)) return false;
+      out.resize(n);
+      return out.size() < raw.size();
+    }
+#endif
+    default:
+      (void)level;
+      (void)raw;
+      (void)out;
+      return false;
+  }
+}
+
+void decompress(SegmentCodec codec, const std::string& stored, std::string& raw) {
+  switch (codec) {
+    case SegmentCodec::None:
+      if (stored.size() != raw.size()) break;
+      std::memcpy(raw.data(), stored.data(), raw.size());
+      return;
+#ifdef BROKER_HAVE_LZ4
+    case SegmentCodec::Lz4:
+      if (LZ4_decompress_safe(stored.data(), raw.data(), static_cast<int>(stored.size()),
+                              static_cast<int>(raw.size())) == static_cast<int>(raw.size())) {
+        return;
+      }
+      break;
+#endif
+#ifdef BROKER_HAVE_ZSTD
+    case SegmentCodec::Zstd:
+      if (ZSTD_decompress(raw.data(), raw.size(), stored.data(), stored.size()) == raw.size()) {
+        return;
+      }
+      break;
+#endif
+    default:
+      // A known codec this build lacks; any other byte is corrupt input.
+      if (codec == SegmentCodec::Lz4 || codec == SegmentCodec::Zstd) {
+        throw std::invalid_argument(ERROR_CODEC_UNAVAILABLE);
+      }
+      break;
+  }
+  throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+}
+
+}  // namespace
+
+bool codec_available(SegmentCodec codec) {
+  switch (codec) {
+    case SegmentCodec::None:
+      return true;
+    case SegmentCodec::Lz4:
+#ifdef BROKER_HAVE_LZ4
+      return true;
+#else
+      return false;
+#endif
+    case SegmentCodec::Zstd:
+#ifdef BROKER_HAVE_ZSTD
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+// SegmentWriter
+SegmentWriter::SegmentWriter(std::ostream& out, SegmentOptions options)
+    : out_(out), options_(options) {
+  if (!codec_available(options_.codec)) {
+    throw std::invalid_argument(ERROR_CODEC_UNAVAILABLE);
+  }
+  if (options_.block_events == 0 || options_.block_events > kMaxBlockEvents) {
+    options_.block_events = SegmentOptions{}.block_events;
+  }
+  pending_.reserve(options_.block_events);
+  out_.write(kSegmentMagic, sizeof(kSegmentMagic));
+  out_.put(static_cast<char>(kSegmentVersion));
+  if (!out_) {
+    throw std::runtime_error(ERROR_SEGMENT_IO);
+  }
+  bytes_ = sizeof(kSegmentMagic) + 1;
+}
+
+SegmentWriter::~SegmentWriter() {
+  try {
+    flush();
+  } catch (...) {
+  }
+}
+
+void SegmentWriter::append(const VideoEvent& event) {
+  pending_.push_back(event);
+  if (pending_.size() == options_.block_events) {
+    write_block();
+  }
+}
+
+void SegmentWriter::append(const VideoEvent* events, size_t n) {
+  for (size_t i = 0; i < n; ++i) append(events[i]);
+}
+
+// Closes the current block early, so everything appended so far is on disk
+// once the stream itself is flushed.
+void SegmentWriter::flush() {
+  if (!pending_.empty()) {
+    write_block();
+  }
+  out_.flush();
+  if (!out_) {
+    throw std::runtime_error(ERROR_SEGMENT_IO);
+  }
+}
+
+void SegmentWriter::write_block() {
+  encode_block(pending_, raw_);
+  SegmentCodec codec = options_.codec;
+  const std::string* payload = &stored_;
+  if (codec == SegmentCodec::None || !compress(codec, options_.level, raw_, stored_)) {
+    codec = SegmentCodec::None;
+    payload = &raw_;
+  }
+
+  std::string header;
+  put_u32(header, static_cast<uint32_t>(pending_.size()));
+  put_u32(header, static_cast<uint32_t>(raw_.size()));
+  put_u32(header, static_cast<uint32_t>(payload->size()));
+  header.push_back(static_cast<char>(codec));
+  out_.write(header.data(), header.size());
+  out_.write(payload->data(), payload->size());
+  if (!out_) {
+    throw std::runtime_error(ERROR_SEGMENT_IO);
+  }
+
+  events_ += pending_.size();
+  bytes_ += header.size() + payload->size();
+  pending_.clear();
+}
+
+uint64_t SegmentWriter::events() const { return events_; }
+
+uint64_t SegmentWriter::bytes() const { return bytes_; }
+
+// SegmentReader
+SegmentReader::SegmentReader(std::istream& in) : in_(in) {
+  char header[sizeof(kSegmentMagic) + 1];
+  if (!in_.read(header, sizeof(header)) ||
+      std::memcmp(header, kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+      static_cast<uint8_t>(header[sizeof(kSegmentMagic)]) != kSegmentVersion) {
+    throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+  }
+}
+
+// Appends the next block (or what next() left of the current one) to out
+// and returns how many events were appended; 0 at end of segment.
+size_t SegmentReader::next_block(std::vector<VideoEvent>& out) {
+  if (block_pos_ == block_.size() && read_block() == 0) {
+    return 0;
+  }
+  const size_t taken = block_.size() - block_pos_;
+  out.insert(out.end(), block_.begin() + block_pos_, block_.end());
+  block_pos_ = block_.size();
+  return taken;
+}
+
+bool SegmentReader::next(VideoEvent& event) {
+  if (block_pos_ == block_.size() && read_block() == 0) {
+    return false;
+  }
+  event = block_[block_pos_++];
+  return true;
+}
+
+size_t SegmentReader::read_block() {
+  block_.clear();
+  block_pos_ = 0;
+  char header[kBlockHeaderSize];
+  in_.read(header, sizeof(header));
+  if (in_.gcount() == 0 && in_.eof()) {
+    return 0;
+  }
+  if (in_.gcount() != static_cast<std::streamsize>(sizeof(header))) {
+    throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+  }
+  const size_t count = get_u32(header);
+  const size_t raw_size = get_u32(header + 4);
+  const size_t stored_size = get_u32(header + 8);
+  const auto codec = static_cast<SegmentCodec>(header[12]);
+  if (count == 0 || count > kMaxBlockEvents || raw_size > count * kMaxEncodedEvent ||
+      stored_size > raw_size + raw_size / 8 + 64) {
+    throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+  }
+
+  stored_.resize(stored_size);
+  if (!in_.read(stored_.data(), stored_size)) {
+    throw std::runtime_error(ERROR_SEGMENT_CORRUPT);
+  }
+  raw_.resize(raw_size);
+  decompress(codec, stored_, raw_);
+  decode_block(raw_, count, block_);
+  return count;
+}
@@ -0,0 +1,53 @@
+#include <broker_system/Executor.h>
+
+// InlineExecutor
+void InlineExecutor::post(std::coroutine_handle<> handle) { handle.resume(); }
+
+InlineExecutor& InlineExecutor::instance() {
+  static InlineExecutor executor;
+  return executor;
+}
+
+// ThreadPoolExecutor
+ThreadPoolExecutor::ThreadPoolExecutor(size_t threads) {
+  if (threads == 0) threads = 1;
+  workers_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    workers_.emplace_back(&ThreadPoolExecutor::run, this);
+  }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() { stop(); }
+
+void ThreadPoolExecutor::post(std::coroutine_handle<> handle) {
+  {
+    std::scoped_lock<std::mutex> lock(mtx_);
+    queue_.push_back(handle);
+  }
+  ready_.notify_one();
+}
+
+void ThreadPoolExecutor::stop() {
+  {
+    std::scoped_lock<std::mutex> lock(mtx_);
+    if (stopped_) return;
+    stopped_ = true;
+  }
+  ready_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) worker.join();
+  }
+}
+
+void ThreadPoolExecutor::run() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (true) {
+    ready_.wait(lock, [this]() { return stopped_ || !queue_.empty(); });
+    if (queue_.empty()) return;
+    std::coroutine_handle<> handle = queue_.front();
+    queue_.pop_front();
+    lock.unlock();
+    handle.resume();
+    lock.lock();
+  }
+}
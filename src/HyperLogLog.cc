@@ -0,0 +1,154 @@
+#include <broker_system/HyperLogLog.h>
+
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// splitmix64 finalizer: cheap and well mixed for sequential user ids.
+uint64_t hll_hash(uint64_t value) {
+  value += 0x9e3779b97f4a7c15ULL;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+// HyperLogLog
+void HyperLogLog::add(uint64_t value) { add_hash(hll_hash(value)); }
+
+void HyperLogLog::add_hash(uint64_t hash) {
+  const size_t index = hash >> (64 - kHllPrecision);
+  const uint64_t rest = (hash << kHllPrecision) | (uint64_t{1} << (kHllPrecision - 1));
+  const uint8_t rank = static_cast<uint8_t>(std::countl_zero(rest) + 1);
+  if (rank > registers_[index]) registers_[index] = rank;
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+  uint8_t* dst = registers_.data();
+  const uint8_t* src = other.registers_.data();
+#if defined(__AVX2__)
+  for (size_t i = 0; i < kRegisters; i += 32) {
+    __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(dst + i));
+    __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_max_epu8(a, b));
+  }
+#elif defined(__SSE2__)
+  for (size_t i = 0; i < kRegisters; i += 16) {
+    __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(dst + i));
+    __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_store_si128(reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(a, b));
+  }
+#elif defined(__ARM_NEON)
+  for (size_t i = 0; i < kRegisters; i += 16) {
+    vst1q_u8(dst + i, vmaxq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+  }
+#else
+  for (size_t i = 0; i < kRegisters; ++i) {
+    if (src[i] > dst[i]) dst[i] = src[i];
+  }
+#endif
+}
+
+double HyperLogLog::estimate() const {
+  const uint8_t* regs = registers_.data();
+  double sum = 0.0;
+  size_t zeros = 0;
+#if defined(__SSE2__)
+  // 2^-r is built directly as a float with exponent (127 - r).
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i bias = _mm_set1_epi32(127);
+  __m128 acc = _mm_setzero_ps();
+  for (size_t i = 0; i < kRegisters; i += 16) {
+    __m128i r = _mm_load_si128(reinterpret_cast<const __m128i*>(regs + i));
+    zeros += std::popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(r, zero))));
+    __m128i lo = _mm_unpacklo_epi8(r, zero);
+    __m128i hi = _mm_unpackhi_epi8(r, zero);
+    __m128i parts[4] = {_mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                        _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)};
+    for (__m128i part : parts) {
+      __m128i exponent = _mm_slli_epi32(_mm_sub_epi32(bias, part), 23);
+      acc = _mm_add_ps(acc, _mm_castsi128_ps(exponent));
+    }
+  }
+  alignas(16) float lanes[4];
+  _mm_store_ps(lanes, acc);
+  sum = static_cast<double>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#else
+  for (size_t i = 0; i < kRegisters; ++i) {
+    sum += std::ldexp(1.0, -regs[i]);
+    zeros += regs[i] == 0;
+  }
+#endif
+
+  const double m = static_cast<double>(kRegisters);
+  const double alpha = 0.7213 / (1.0 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+  if (estimate <= 2.5 * m && zeros != 0) {
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  }
+  return estimate;
+}
+
+void HyperLogLog::clear() { registers_.fill(0); }
+
+const std::array<uint8_t, HyperLogLog::kRegisters>& HyperLogLog::registers() const {
+  return registers_;
+}
+
+// DistinctViewers
+DistinctViewers::DistinctViewers() : videos_(kVideoCount), creators_(kCreatorCount) {}
+
+void DistinctViewers::add(const VideoEvent& event) {
+  const uint64_t hash = hll_hash(event.user_id);
+  videos_[event.video_id % kVideoCount].add_hash(hash);
+  creators_[event.creator_id % kCreatorCount].add_hash(hash);
+}
+
+void DistinctViewers::add_batch(const VideoEvent* events, size_t n) {
+  for (size_t i = 0; i < n; ++i) add(events[i]);
+}
+
+void DistinctViewers::add_batch(const std::vector<VideoEvent>& batch) {
+  add_batch(batch.data(), batch.size());
+}
+
+// Feeds pop_bulk batches until the source reaches end of stream.
+void DistinctViewers::run(RingBuffer<VideoEvent>& source, size_t batch_size) {
+  if (batch_size == 0) {
+    throw std::invalid_argument(ERROR_BULK_SIZE);
+  }
+  std::vector<VideoEvent> batch;
+  batch.reserve(batch_size);
+  while (source.pop_bulk(batch, batch_size) != 0) {
+    add_batch(batch);
+    batch.clear();
+  }
+}
+
+void DistinctViewers::merge(const DistinctViewers& other) {
+  for (size_t i = 0; i < videos_.size(); ++i) videos_[i].merge(other.videos_[i]);
+  for (size_t i = 0; i < creators_.size(); ++i) creators_[i].merge(other.creators_[i]);
+}
+
+double DistinctViewers::video_estimate(uint32_t video_id) const {
+  return video(video_id).estimate();
+}
+
+double DistinctViewers::creator_estimate(uint8_t creator_id) const {
+  return creator(creator_id).estimate();
+}
+
+const HyperLogLog& DistinctViewers::video(uint32_t video_id) const {
+  return videos_.at(video_id);
+}
+
+const HyperLogLog& DistinctViewers::creator(uint8_t creator_id) const {
+  return creators_.at(creator_id);
+}
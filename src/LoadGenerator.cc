@@ -0,0 +1,242 @@
+#include <broker_system/LoadGenerator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <broker_system/TcpClient.h>
+
+// SplitMix64
+SplitMix64::result_type SplitMix64::operator()() {
+  uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+double SplitMix64::uniform() {
+  return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+}
+
+// ZipfDistribution
+ZipfDistribution::ZipfDistribution(uint32_t n, double exponent)
+    : prob_(n), alias_(n) {
+  std::vector<double> scaled(n);
+  double total = 0;
+  for (uint32_t k = 0; k < n; ++k) {
+    scaled[k] = 1.0 / std::pow(static_cast<double>(k + 1), exponent);
+    total += scaled[k];
+  }
+
+  std::vector<uint32_t> small, large;
+  for (uint32_t k = 0; k < n; ++k) {
+    scaled[k] *= n / total;
+    (scaled[k] < 1.0 ? small : large).push_back(k);
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t s = small.back();
+    uint32_t l = large.back();
+    small.pop_back();
+    prob_[s] = scaled[s];
+    alias_[s] = l;
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  for (uint32_t k : large) prob_[k] = 1.0;
+  for (uint32_t k : small) prob_[k] = 1.0;
+}
+
+uint32_t ZipfDistribution::operator()(SplitMix64& rng) const {
+  uint32_t column = static_cast<uint32_t>(rng() % prob_.size());
+  return rng.uniform() < prob_[column] ? column : alias_[column];
+}
+
+// EventStream
+EventStream::EventStream(const LoadProfile& profile, size_t thread_index)
+    : profile_(profile),
+      rng_(profile.seed ^ (0x9e3779b97f4a7c15ULL * (thread_index + 1))),
+      zipf_(profile.videos, profile.zipf_exponent),
+      producer_id_(profile.first_producer_id + static_cast<uint32_t>(thread_index)) {
+  const EventMix& mix = profile.mix;
+  const double weights[kEventTypeCount] = {mix.view, mix.like, mix.dislike,
+                                           mix.comment, mix.watch};
+  double total = 0;
+  for (size_t i = 0; i < kEventTypeCount; ++i) {
+    total += weights[i];
+    mix_cdf_[i] = total;
+  }
+  for (double& edge : mix_cdf_) edge /= total;
+
+  const double rate = profile.events_per_second > 0 ? profile.events_per_second : 1e6;
+  ms_per_event_ = 1000.0 * static_cast<double>(profile.threads) / rate;
+}
+
+// Returns true when the batch belongs to a burst.
+bool EventStream::next_batch(std::vector<VideoEvent>& out, size_t n) {
+  if (burst_left_ == 0 && profile_.burst_probability > 0 &&
+      rng_.uniform() < profile_.burst_probability) {
+    burst_left_ = std::max<size_t>(profile_.burst_batches, 1);
+    burst_video_ = zipf_(rng_);
+  }
+  const bool burst = burst_left_ != 0;
+  if (burst) --burst_left_;
+
+  out.reserve(out.size() + n);
+  for (size_t i = 0; i < n; ++i) {
+    out.push_back(burst ? make_event(burst_video_) : next());
+  }
+  return burst;
+}
+
+VideoEvent EventStream::next() { return make_event(zipf_(rng_)); }
+
+VideoEvent EventStream::make_event(uint32_t video) {
+  VideoEvent event;
+  event.sequence = ++sequence_;
+  event.producer_id = producer_id_;
+  event.timestamp_ms = profile_.start_timestamp_ms +
+                       static_cast<uint64_t>(event.sequence * ms_per_event_);
+  event.user_id = static_cast<uint32_t>(rng_() % profile_.users);
+  event.video_id = video;
+  event.creator_id = creator_of(video);
+
+  const double pick = rng_.uniform();
+  size_t type = 0;
+  while (type + 1 < kEventTypeCount && pick >= mix_cdf_[type]) ++type;
+  event.type = static_cast<EventType>(type);
+  if (event.type == EventType::WatchDuration) {
+    event.watch_ms = 1000 + static_cast<uint32_t>(rng_() % 600000);
+  }
+  return event;
+}
+
+// Wire format
+namespace {
+
+char* put_le(char* out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) *out++ = static_cast<char>(value >> (8 * i));
+  return out;
+}
+
+uint64_t get_le(const char*& in, int bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; ++i) value |= uint64_t{static_cast<uint8_t>(*in++)} << (8 * i);
+  return value;
+}
+
+}  // namespace
+
+void encode_event(const VideoEvent& event, char* out) {
+  out = put_le(out, event.timestamp_ms, 8);
+  out = put_le(out, event.sequence, 8);
+  out = put_le(out, event.producer_id, 4);
+  out = put_le(out, event.user_id, 4);
+  out = put_le(out, event.video_id, 4);
+  out = put_le(out, event.watch_ms, 4);
+  out = put_le(out, event.creator_id, 1);
+  put_le(out, static_cast<uint8_t>(event.type), 1);
+}
+
+VideoEvent decode_event(const char* in) {
+  VideoEvent event;
+  event.timestamp_ms = get_le(in, 8);
+  event.sequence = get_le(in, 8);
+  event.producer_id = static_cast<uint32_t>(get_le(in, 4));
+  event.user_id = static_cast<uint32_t>(get_le(in, 4));
+  event.video_id = static_cast<uint32_t>(get_le(in, 4));
+  event.watch_ms = static_cast<uint32_t>(get_le(in, 4));
+  event.creator_id = static_cast<uint8_t>(get_le(in, 1));
+  event.type = static_cast<EventType>(get_le(in, 1));
+  return event;
+}
+
+// Sinks
+SinkFactory ring_sink(RingBuffer<VideoEvent>& ring) {
+  return [&ring](size_t) -> EventSink {
+    return [&ring](const VideoEvent* events, size_t n) {
+      for (size_t i = 0; i < n; ++i) {
+        if (!ring.push(events[i])) return false;
+      }
+      return true;
+    };
+  };
+}
+
+SinkFactory loopback_sink(const std::string& host, uint16_t port) {
+  return [host, port](size_t) -> EventSink {
+    auto client = std::make_shared<TcpClient>();
+    if (!client->connect(host, port)) {
+      return [](const VideoEvent*, size_t) { return false; };
+    }
+    return [client, wire = std::string()](const VideoEvent* events, size_t n) mutable {
+      wire.resize(n * kEventWireSize);
+      for (size_t i = 0; i < n; ++i) encode_event(events[i], wire.data() + i * kEventWireSize);
+      return client->send_all(wire);
+    };
+  };
+}
+
+// LoadGenerator
+LoadGenerator::LoadGenerator(LoadProfile profile) : profile_(std::move(profile)) {
+  const EventMix& mix = profile_.mix;
+  if (profile_.threads == 0 || profile_.videos == 0 || profile_.users == 0 ||
+      mix.view + mix.like + mix.dislike + mix.comment + mix.watch <= 0) {
+    throw std::invalid_argument(ERROR_LOAD_PROFILE);
+  }
+  profile_.batch_size = std::max<size_t>(profile_.batch_size, 1);
+}
+
+LoadStats LoadGenerator::run(const SinkFactory& make_sink) {
+  std::vector<uint64_t> sent(profile_.threads, 0);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < profile_.threads; ++t) {
+    threads.emplace_back([&, t]() { sent[t] = produce(t, make_sink(t)); });
+  }
+  for (auto& thread : threads) thread.join();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  LoadStats stats;
+  for (uint64_t n : sent) stats.events += n;
+  stats.seconds = elapsed.count();
+  stats.events_per_second = stats.seconds > 0 ? stats.events / stats.seconds : 0;
+  return stats;
+}
+
+LoadStats LoadGenerator::run(RingBuffer<VideoEvent>& ring) {
+  return run(ring_sink(ring));
+}
+
+const LoadProfile& LoadGenerator::profile() const { return profile_; }
+
+uint64_t LoadGenerator::produce(size_t thread_index, EventSink sink) {
+  const uint64_t quota = profile_.events / profile_.threads +
+                         (thread_index < profile_.events % profile_.threads ? 1 : 0);
+  const double rate = profile_.events_per_second / profile_.threads;
+
+  EventStream stream(profile_, thread_index);
+  std::vector<VideoEvent> batch;
+  batch.reserve(profile_.batch_size);
+  auto start = std::chrono::steady_clock::now();
+  uint64_t sent = 0;
+
+  while (sent < quota) {
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(profile_.batch_size, quota - sent));
+    batch.clear();
+    const bool burst = stream.next_batch(batch, n);
+    if (rate > 0 && !burst) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::duration<double>(sent / rate)));
+    }
+    if (!sink(batch.data(), n)) break;
+    sent += n;
+  }
+  return sent;
+}
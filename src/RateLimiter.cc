@@ -0,0 +1,48 @@
+#include <broker_system/RateLimiter.h>
+
+#include <stdexcept>
+#include <thread>
+
+TokenBucket::TokenBucket(double rate, double burst)
+    : rate_(rate), burst_(burst), tokens_(burst), last_(Clock::now()) {
+  if (rate <= 0 || burst <= 0) {
+    throw std::invalid_argument(ERROR_TOKEN_BUCKET);
+  }
+}
+
+bool TokenBucket::try_acquire(double tokens) {
+  refill(Clock::now());
+  if (tokens_ < tokens) return false;
+  tokens_ -= tokens;
+  return true;
+}
+
+// Requests larger than burst are allowed and simply wait longer.
+void TokenBucket::acquire(double tokens) {
+  refill(Clock::now());
+  tokens_ -= tokens;
+  if (tokens_ < 0) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(-tokens_ / rate_));
+  }
+}
+
+void TokenBucket::set_rate(double rate) {
+  if (rate <= 0) {
+    throw std::invalid_argument(ERROR_TOKEN_BUCKET);
+  }
+  refill(Clock::now());
+  rate_ = rate;
+}
+
+double TokenBucket::rate() const { return rate_; }
+
+double TokenBucket::available() {
+  refill(Clock::now());
+  return tokens_;
+}
+
+void TokenBucket::refill(Clock::time_point now) {
+  std::chrono::duration<double> elapsed = now - last_;
+  last_ = now;
+  tokens_ = std::min(burst_, tokens_ + elapsed.count() * rate_);
+}
@@ -0,0 +1,38 @@
+#include <broker_system/ShardedBroker.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+bool pin_current_thread(size_t cpu) {
+#if defined(__linux__)
+  if (cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+std::vector<size_t> allowed_cpus() {
+  std::vector<size_t> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    for (long cpu = 0; cpu < (n > 0 ? n : 1); ++cpu) cpus.push_back(static_cast<size_t>(cpu));
+  }
+  return cpus;
+}
@@ -0,0 +1,145 @@
+#include <broker_system/SubscriptionRouter.h>
+
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// EventFilter
+bool EventFilter::matches(const VideoEvent& event) const {
+  return (type_mask & type_bit(event.type)) != 0 && event.video_id >= video_min &&
+         event.video_id <= video_max && (!creator || *creator == event.creator_id);
+}
+
+// EventHeaders
+void EventHeaders::build(const VideoEvent* events, size_t n) {
+  video_id.resize(n);
+  type_bit.resize(n);
+  creator_id.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    video_id[i] = events[i].video_id;
+    type_bit[i] = ::type_bit(events[i].type);
+    creator_id[i] = events[i].creator_id;
+  }
+}
+
+size_t EventHeaders::size() const { return video_id.size(); }
+
+void match_headers(const EventHeaders& headers, const EventFilter& filter, uint8_t* mask) {
+  const size_t n = headers.size();
+  const uint32_t* video = headers.video_id.data();
+  const uint8_t* type = headers.type_bit.data();
+  const uint8_t* creator = headers.creator_id.data();
+  const bool any_creator = !filter.creator.has_value();
+  const uint8_t wanted_creator = filter.creator.value_or(0);
+  size_t i = 0;
+#if defined(__SSE2__)
+  // SSE2 has no unsigned compare: flipping the sign bit of both sides makes
+  // the signed compare order them as unsigned.
+  const __m128i sign = _mm_set1_epi32(INT32_MIN);
+  const __m128i lo = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(filter.video_min)), sign);
+  const __m128i hi = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(filter.video_max)), sign);
+  const __m128i types = _mm_set1_epi8(static_cast<char>(filter.type_mask));
+  const __m128i wanted = _mm_set1_epi8(static_cast<char>(wanted_creator));
+  const __m128i any = _mm_set1_epi8(any_creator ? -1 : 0);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= n; i += 16) {
+    __m128i out_of_range[4];
+    for (int k = 0; k < 4; ++k) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(video + i + 4 * k));
+      v = _mm_xor_si128(v, sign);
+      out_of_range[k] = _mm_or_si128(_mm_cmpgt_epi32(lo, v), _mm_cmpgt_epi32(v, hi));
+    }
+    __m128i reject = _mm_packs_epi16(_mm_packs_epi32(out_of_range[0], out_of_range[1]),
+                                     _mm_packs_epi32(out_of_range[2], out_of_range[3]));
+
+    __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(type + i));
+    reject = _mm_or_si128(reject, _mm_cmpeq_epi8(_mm_and_si128(t, types), zero));
+
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(creator + i));
+    __m128i creator_ok = _mm_or_si128(_mm_cmpeq_epi8(c, wanted), any);
+    reject = _mm_or_si128(reject, _mm_cmpeq_epi8(creator_ok, zero));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mask + i), _mm_cmpeq_epi8(reject, zero));
+  }
+#endif
+  for (; i < n; ++i) {
+    mask[i] = (filter.type_mask & type[i]) != 0 && video[i] >= filter.video_min &&
+              video[i] <= filter.video_max && (any_creator || creator[i] == wanted_creator);
+  }
+}
+
+// SubscriptionRouter
+SubscriptionRouter::SubscriptionRouter(std::chrono::milliseconds push_timeout) : push_timeout_(push_timeout) {}
+
+size_t SubscriptionRouter::subscribe(const EventFilter& filter, RingBuffer<VideoEvent>& queue) {
+  subscriptions_.push_back(std::make_unique<Subscription>(filter, queue));
+  return subscriptions_.size() - 1;
+}
+
+// Returns how many events were pushed over all subscriptions. Each
+// subscriber shares one push deadline per batch; once it has passed a push
+// only succeeds if there is room right away. A subscriber whose queue was
+// closed gets nothing more, its matches are counted as dropped.
+size_t SubscriptionRouter::route(const VideoEvent* events, size_t n) {
+  headers_.build(events, n);
+  mask_.resize(n);
+  size_t pushed = 0;
+  for (auto& subscription : subscriptions_) {
+    match_headers(headers_, subscription->filter, mask_.data());
+    const auto deadline = std::chrono::steady_clock::now() + push_timeout_;
+    size_t matched = 0;
+    size_t delivered = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (!mask_[i]) continue;
+      ++matched;
+      if (!subscription->open) continue;
+      if (subscription->queue->push_until(events[i], deadline)) {
+        ++delivered;
+      } else if (subscription->queue->closed()) {
+        subscription->open = false;
+      }
+    }
+    subscription->delivered.fetch_add(delivered, std::memory_order_relaxed);
+    subscription->filtered.fetch_add(n - matched, std::memory_order_relaxed);
+    subscription->dropped.fetch_add(matched - delivered, std::memory_order_relaxed);
+    pushed += delivered;
+  }
+  return pushed;
+}
+
+size_t SubscriptionRouter::route(const std::vector<VideoEvent>& batch) {
+  return route(batch.data(), batch.size());
+}
+
+// Routes until source reaches end of stream, then closes every subscriber
+// queue so their consumers see end of stream too.
+void SubscriptionRouter::run(RingBuffer<VideoEvent>& source, size_t batch_size) {
+  if (batch_size == 0) {
+    throw std::invalid_argument(ERROR_ROUTER_BATCH);
+  }
+  std::vector<VideoEvent> batch;
+  batch.reserve(batch_size);
+  while (source.pop_bulk(batch, batch_size) != 0) {
+    route(batch);
+    batch.clear();
+  }
+  for (auto& subscription : subscriptions_) {
+    subscription->queue->close();
+  }
+}
+
+size_t SubscriptionRouter::subscribers() const { return subscriptions_.size(); }
+
+uint64_t SubscriptionRouter::delivered(size_t subscription) const {
+  return subscriptions_.at(subscription)->delivered.load(std::memory_order_relaxed);
+}
+
+uint64_t SubscriptionRouter::filtered(size_t subscription) const {
+  return subscriptions_.at(subscription)->filtered.load(std::memory_order_relaxed);
+}
+
+uint64_t SubscriptionRouter::dropped(size_t subscription) const {
+  return subscriptions_.at(subscription)->dropped.load(std::memory_order_relaxed);
+}
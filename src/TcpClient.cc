@@ -0,0 +1,93 @@
+#include <broker_system/TcpClient.h>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace {
+
+void set_socket_timeout(int fd, std::chrono::milliseconds timeout) {
+  timeval tv{};
+  tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+  tv.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000);
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+}  // namespace
+
+TcpClient::~TcpClient() { close(); }
+
+void TcpClient::set_timeout(std::chrono::milliseconds timeout) {
+  timeout_ = timeout;
+  if (fd_ >= 0) set_socket_timeout(fd_, timeout_);
+}
+
+bool TcpClient::connect(const std::string& host, uint16_t port) {
+  close();
+
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* res = nullptr;
+  const std::string service = std::to_string(port);
+  if (getaddrinfo(host.c_str(), service.c_str(), &hints, &res) != 0) {
+    return false;
+  }
+
+  for (addrinfo* ai = res; ai != nullptr; ai = ai->ai_next) {
+    int fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0) continue;
+    set_socket_timeout(fd, timeout_);
+    if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      fd_ = fd;
+      break;
+    }
+    ::close(fd);
+  }
+  freeaddrinfo(res);
+  return fd_ >= 0;
+}
+
+bool TcpClient::send_all(std::string_view data) {
+  if (fd_ < 0) return false;
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent,
+                       MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      close();
+      return false;
+    }
+    sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+ssize_t TcpClient::recv_some(char* buf, size_t len) {
+  if (fd_ < 0) return -1;
+  ssize_t n;
+  do {
+    n = ::recv(fd_, buf, len, 0);
+  } while (n < 0 && errno == EINTR);
+  if (n <= 0) close();
+  return n;
+}
+
+bool TcpClient::connected() const { return fd_ >= 0; }
+
+void TcpClient::close() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
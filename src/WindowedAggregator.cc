@@ -0,0 +1,94 @@
+#include <broker_system/WindowedAggregator.h>
+
+#include <stdexcept>
+
+WindowedAggregator::WindowedAggregator(uint64_t window_ms, uint64_t slide_ms,
+                                       Callback on_window)
+    : window_ms_(window_ms),
+      slide_ms_(slide_ms),
+      on_window_(std::move(on_window)) {
+  if (window_ms == 0 || slide_ms == 0 || window_ms % slide_ms != 0) {
+    throw std::invalid_argument(ERROR_WINDOW_SIZE);
+  }
+  panes_.resize(window_ms / slide_ms);
+}
+
+void WindowedAggregator::consume(const VideoEvent* events, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    const VideoEvent& event = events[i];
+    if (!started_) {
+      pane_start_ = event.timestamp_ms - event.timestamp_ms % slide_ms_;
+      started_ = true;
+    }
+    if (event.timestamp_ms < pane_start_) {
+      ++late_;
+      continue;
+    }
+    while (event.timestamp_ms >= pane_start_ + slide_ms_) {
+      if (totals_.events == 0 && panes_[head_].events == 0) {
+        // Nothing left in the window: skip the idle gap in one step.
+        pane_start_ = event.timestamp_ms - event.timestamp_ms % slide_ms_;
+        break;
+      }
+      close_pane();
+    }
+
+    Pane& pane = panes_[head_];
+    pane.videos.record(event.video_id % kVideoCount, event);
+    pane.creators.record(event.creator_id % kCreatorCount, event);
+    ++pane.events;
+  }
+}
+
+void WindowedAggregator::consume(const std::vector<VideoEvent>& batch) {
+  consume(batch.data(), batch.size());
+}
+
+// Aggregates pop_bulk batches until the source reaches end of stream.
+void WindowedAggregator::run(RingBuffer<VideoEvent>& source,
+                             size_t batch_size) {
+  if (batch_size == 0) {
+    throw std::invalid_argument(ERROR_BULK_SIZE);
+  }
+  std::vector<VideoEvent> batch;
+  batch.reserve(batch_size);
+  while (source.pop_bulk(batch, batch_size) != 0) {
+    consume(batch);
+    batch.clear();
+  }
+  flush();
+}
+
+// Closes the open pane without waiting for a newer event.
+void WindowedAggregator::flush() {
+  if (started_) close_pane();
+}
+
+uint64_t WindowedAggregator::late_events() const { return late_; }
+
+void WindowedAggregator::close_pane() {
+  Pane& closing = panes_[head_];
+  if (closing.events != 0) {
+    totals_.videos.add(closing.videos);
+    totals_.creators.add(closing.creators);
+    totals_.events += closing.events;
+  }
+
+  const uint64_t end = pane_start_ + slide_ms_;
+  if (totals_.events != 0 && on_window_) {
+    const uint64_t start = end > window_ms_ ? end - window_ms_ : 0;
+    on_window_({start, end, totals_.events, totals_.videos, totals_.creators});
+  }
+
+  head_ = (head_ + 1) % panes_.size();
+  Pane& expired = panes_[head_];
+  if (expired.events != 0) {
+    totals_.videos.sub(expired.videos);
+    totals_.creators.sub(expired.creators);
+    totals_.events -= expired.events;
+    expired.videos.clear();
+    expired.creators.clear();
+    expired.events = 0;
+  }
+  pane_start_ = end;
+}
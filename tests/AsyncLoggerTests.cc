@@ -0,0 +1,324 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <broker_system/AsyncLogger.h>
+
+// In-process stand-in for Redis: accepts RESP arrays over loopback and
+// answers every command with an integer reply, or with an error reply for
+// every error_every-th command when that is non-zero.
+class RespStandIn {
+ public:
+  explicit RespStandIn(size_t error_every = 0) : error_every_(error_every) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::listen(listen_fd_, 4);
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    server_ = std::thread(&RespStandIn::serve, this);
+  }
+
+  ~RespStandIn() {
+    stop_ = true;
+    server_.join();
+    ::close(listen_fd_);
+  }
+
+  uint16_t port() const { return port_; }
+
+  std::vector<std::vector<std::string>> commands() {
+    std::scoped_lock<std::mutex> lock(mtx_);
+    return commands_;
+  }
+
+ private:
+  void serve() {
+    int client = -1;
+    std::string pending;
+    while (!stop_) {
+      pollfd pfd{client < 0 ? listen_fd_ : client, POLLIN, 0};
+      if (::poll(&pfd, 1, 20) <= 0) continue;
+      if (client < 0) {
+        client = ::accept(listen_fd_, nullptr, nullptr);
+        continue;
+      }
+      char buf[4096];
+      ssize_t n = ::recv(client, buf, sizeof(buf), 0);
+      if (n <= 0) {
+        ::close(client);
+        client = -1;
+        pending.clear();
+        continue;
+      }
+      pending.append(buf, n);
+      std::vector<std::string> cmd;
+      std::string replies;
+      while (parse(pending, cmd)) {
+        ++answered_;
+        if (error_every_ != 0 && answered_ % error_every_ == 0) {
+          replies += "-ERR wrong number of arguments\r\n";
+        } else {
+          replies += ":" + std::to_string(cmd.size()) + "\r\n";
+        }
+        std::scoped_lock<std::mutex> lock(mtx_);
+        commands_.push_back(std::move(cmd));
+      }
+      ::send(client, replies.data(), replies.size(), MSG_NOSIGNAL);
+    }
+    if (client >= 0) ::close(client);
+  }
+
+  static bool parse(std::string& in, std::vector<std::string>& cmd) {
+    cmd.clear();
+    size_t pos = 0;
+    auto read_line = [&](std::string& line) {
+      size_t end = in.find("\r\n", pos);
+      if (end == std::string::npos) return false;
+      line = in.substr(pos, end - pos);
+      pos = end + 2;
+      return true;
+    };
+    std::string line;
+    if (!read_line(line) || line[0] != '*') return false;
+    size_t argc = std::stoul(line.substr(1));
+    for (size_t i = 0; i < argc; ++i) {
+      if (!read_line(line) || line[0] != '$') return false;
+      size_t len = std::stoul(line.substr(1));
+      if (in.size() < pos + len + 2) return false;
+      cmd.push_back(in.substr(pos, len));
+      pos += len + 2;
+    }
+    in.erase(0, pos);
+    return true;
+  }
+
+  size_t error_every_;
+  size_t answered_ = 0;
+  int listen_fd_;
+  uint16_t port_;
+  std::atomic<bool> stop_{false};
+  std::thread server_;
+  std::mutex mtx_;
+  std::vector<std::vector<std::string>> commands_;
+};
+
+// Sink that holds every write until released, emulating a stalled Redis.
+class StalledSink : public RespSink {
+ public:
+  size_t write(const std::string&, size_t commands) override {
+    std::unique_lock<std::mutex> lock(mtx_);
+    released_cv_.wait(lock, [this]() { return released_; });
+    return commands;
+  }
+
+  void release() {
+    std::scoped_lock<std::mutex> lock(mtx_);
+    released_ = true;
+    released_cv_.notify_all();
+  }
+
+ private:
+  std::mutex mtx_;
+  std::condition_variable released_cv_;
+  bool released_ = false;
+};
+
+class FailingSink : public RespSink {
+ public:
+  size_t write(const std::string&, size_t) override { return 0; }
+};
+
+class CountingSink : public RespSink {
+ public:
+  size_t write(const std::string&, size_t commands) override { return commands; }
+};
+
+TEST(AsyncLogger, RespEncoding) {
+  std::string out;
+  resp_append_command(out, {"RPUSH", "key", "hello"});
+  ASSERT_EQ(out, "*3\r\n$5\r\nRPUSH\r\n$3\r\nkey\r\n$5\r\nhello\r\n");
+}
+
+TEST(AsyncLogger, DeliversPipelinedCommands) {
+  RespStandIn redis;
+  AsyncLoggerOptions options;
+  options.batch_size = 64;
+  AsyncLogger logger(std::make_shared<TcpRespSink>("127.0.0.1", redis.port()),
+                     options);
+
+  const int per_thread = 500;
+  auto producer = [&](LogCategory category) {
+    for (int i = 0; i < per_thread; ++i) {
+      while (!logger.log(category, "event " + std::to_string(i))) {
+        std::this_thread::yield();
+      }
+    }
+  };
+  std::thread t1(producer, LogCategory::Incoming);
+  std::thread t2(producer, LogCategory::Outgoing);
+  t1.join();
+  t2.join();
+  logger.stop();
+
+  auto commands = redis.commands();
+  ASSERT_EQ(commands.size(), 2 * per_thread);
+  ASSERT_EQ(logger.flushed(), 2 * per_thread);
+
+  size_t incoming = 0;
+  for (auto& cmd : commands) {
+    ASSERT_EQ(cmd.size(), 3);
+    ASSERT_EQ(cmd[0], "RPUSH");
+    if (cmd[1] == "broker:log:incoming") ++incoming;
+  }
+  ASSERT_EQ(incoming, per_thread);
+}
+
+TEST(AsyncLogger, DropsWhenSinkFallsBehind) {
+  auto sink = std::make_shared<StalledSink>();
+  AsyncLoggerOptions options;
+  options.ring_capacity = 8;
+  options.batch_size = 4;
+  AsyncLogger logger(sink, options);
+
+  const int total = 100;
+  int accepted = 0;
+  for (int i = 0; i < total; ++i) {
+    if (logger.log(LogCategory::Meta, "sample")) ++accepted;
+  }
+  ASSERT_LT(accepted, total);
+  ASSERT_EQ(logger.logged(), accepted);
+  ASSERT_EQ(logger.dropped(), total - accepted);
+
+  sink->release();
+  logger.stop();
+  ASSERT_EQ(logger.flushed(), accepted);
+}
+
+TEST(AsyncLogger, CountsSinkFailures) {
+  AsyncLogger logger(std::make_shared<FailingSink>());
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(logger.log(LogCategory::Error, "boom"));
+  }
+  logger.flush();
+  ASSERT_EQ(logger.sink_dropped(), 10);
+  ASSERT_EQ(logger.dropped(), 10);
+  ASSERT_EQ(logger.flushed(), 0);
+}
+
+TEST(AsyncLogger, ErrorRepliesAreNotFlushed) {
+  RespStandIn redis(4);
+  AsyncLoggerOptions options;
+  options.batch_size = 16;
+  AsyncLogger logger(std::make_shared<TcpRespSink>("127.0.0.1", redis.port()),
+                     options);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(logger.log(LogCategory::Meta, "event"));
+  }
+  logger.stop();
+  ASSERT_EQ(redis.commands().size(), 100);
+  ASSERT_EQ(logger.sink_dropped(), 25);
+  ASSERT_EQ(logger.flushed(), 75);
+}
+
+// Every log() that returned true while stop() ran must reach the sink.
+TEST(AsyncLogger, LogRacingStopIsFlushed) {
+  for (int round = 0; round < 20; ++round) {
+    AsyncLogger logger(std::make_shared<CountingSink>());
+    std::atomic<uint64_t> accepted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+      threads.emplace_back([&]() {
+        int misses = 0;
+        while (misses < 100) {
+          if (logger.log(LogCategory::Incoming, "racing")) {
+            ++accepted;
+          } else {
+            ++misses;
+          }
+        }
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    logger.stop();
+    for (auto& thread : threads) thread.join();
+    ASSERT_EQ(logger.logged(), accepted.load());
+    ASSERT_EQ(logger.flushed(), accepted.load());
+  }
+}
+
+TEST(AsyncLogger, ManyLoggersOnOneThread) {
+  for (int i = 0; i < 200; ++i) {
+    AsyncLogger logger(std::make_shared<CountingSink>());
+    ASSERT_TRUE(logger.log(LogCategory::Meta, "short-lived"));
+    logger.stop();
+    ASSERT_EQ(logger.flushed(), 1);
+  }
+}
+
+TEST(AsyncLogger, ExitedThreadsReleaseTheirRings) {
+  AsyncLogger logger(std::make_shared<CountingSink>());
+  for (int i = 0; i < 50; ++i) {
+    std::thread([&]() { logger.log(LogCategory::Meta, "short-lived thread"); }).join();
+  }
+  logger.flush();
+  ASSERT_EQ(logger.rings(), 0);
+  ASSERT_EQ(logger.logged(), 50);
+  ASSERT_EQ(logger.flushed(), 50);
+
+  logger.log(LogCategory::Meta, "still alive");
+  logger.flush();
+  ASSERT_EQ(logger.rings(), 1);
+  ASSERT_EQ(logger.logged(), 51);
+}
+
+// Accepts connections (through the backlog) but never answers.
+class SilentServer {
+ public:
+  SilentServer() {
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::listen(fd_, 4);
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+  }
+  ~SilentServer() { ::close(fd_); }
+  uint16_t port() const { return port_; }
+
+ private:
+  int fd_;
+  uint16_t port_;
+};
+
+TEST(AsyncLogger, UnresponsiveServerTimesOut) {
+  SilentServer server;
+  AsyncLogger logger(std::make_shared<TcpRespSink>("127.0.0.1", server.port(),
+                                                   std::chrono::milliseconds(50)));
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(logger.log(LogCategory::Error, "nobody listens"));
+  }
+  auto start = std::chrono::steady_clock::now();
+  logger.stop();
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  ASSERT_EQ(logger.sink_dropped(), 10);
+  ASSERT_EQ(logger.flushed(), 0);
+}
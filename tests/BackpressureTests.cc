@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+#include <broker_system/RateLimiter.h>
+#include <broker_system/RingBuffer.h>
+
+TEST(Backpressure, WatermarksException) {
+  RingBuffer<int> rbuf(10);
+  ASSERT_THROW(rbuf.set_watermarks(6, 5), std::invalid_argument);
+  ASSERT_THROW(rbuf.set_watermarks(5, 11), std::invalid_argument);
+}
+
+TEST(Backpressure, PressureLevels) {
+  RingBuffer<int> rbuf(10);
+  rbuf.set_watermarks(4, 8);
+  ASSERT_EQ(rbuf.pressure(), PressureLevel::Normal);
+  for (int i = 0; i < 4; ++i) rbuf.push(i);
+  ASSERT_EQ(rbuf.pressure(), PressureLevel::Elevated);
+  for (int i = 0; i < 4; ++i) rbuf.push(i);
+  ASSERT_EQ(rbuf.pressure(), PressureLevel::High);
+  rbuf.push(0);
+  rbuf.push(0);
+  ASSERT_EQ(rbuf.pressure(), PressureLevel::Full);
+  ASSERT_DOUBLE_EQ(rbuf.fill_ratio(), 1.0);
+
+  std::vector<int> out;
+  rbuf.pop_bulk(out, 10);
+  ASSERT_EQ(rbuf.pressure(), PressureLevel::Normal);
+}
+
+TEST(Backpressure, CallbackOnTransitionsOnly) {
+  RingBuffer<int> rbuf(4);
+  std::vector<PressureLevel> changes;
+  rbuf.set_watermarks(2, 3, [&](PressureLevel level) { changes.push_back(level); });
+
+  for (int i = 0; i < 4; ++i) rbuf.push(i);
+  int msg;
+  for (int i = 0; i < 4; ++i) rbuf.pop(msg);
+
+  std::vector<PressureLevel> expected = {
+      PressureLevel::Elevated, PressureLevel::High, PressureLevel::Full,
+      PressureLevel::High,     PressureLevel::Elevated, PressureLevel::Normal};
+  ASSERT_EQ(changes, expected);
+}
+
+TEST(Backpressure, TokenBucketException) {
+  ASSERT_THROW(TokenBucket(0, 1), std::invalid_argument);
+  ASSERT_THROW(TokenBucket(1, 0), std::invalid_argument);
+}
+
+TEST(Backpressure, TokenBucketBurstThenRate) {
+  TokenBucket bucket(1000, 10);
+  for (int i = 0; i < 10; ++i) ASSERT_TRUE(bucket.try_acquire());
+  ASSERT_FALSE(bucket.try_acquire());
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 50; ++i) bucket.acquire();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_GE(elapsed.count(), 0.045);
+}
+
+TEST(Backpressure, AdaptiveRateException) {
+  RingBuffer<int> rbuf(10);
+  ASSERT_THROW(AdaptiveRateLimiter<int>(rbuf, 1000, 100, 0), std::invalid_argument);
+  ASSERT_THROW(AdaptiveRateLimiter<int>(rbuf, 1000, 100, -0.5), std::invalid_argument);
+  ASSERT_THROW(AdaptiveRateLimiter<int>(rbuf, 1000, 100, 1.5), std::invalid_argument);
+  ASSERT_NO_THROW(AdaptiveRateLimiter<int>(rbuf, 1000, 100, 1));
+}
+
+TEST(Backpressure, AdaptiveRateFollowsFillLevel) {
+  RingBuffer<int> rbuf(100);
+  rbuf.set_watermarks(50, 90);
+  AdaptiveRateLimiter<int> limiter(rbuf, 1000, 100, 0.1);
+
+  limiter.try_acquire();
+  ASSERT_DOUBLE_EQ(limiter.current_rate(), 1000);
+
+  for (int i = 0; i < 70; ++i) rbuf.push(i);
+  limiter.try_acquire();
+  ASSERT_NEAR(limiter.current_rate(), 550, 1e-6);
+
+  for (int i = 0; i < 25; ++i) rbuf.push(i);
+  limiter.try_acquire();
+  ASSERT_NEAR(limiter.current_rate(), 100, 1e-6);
+}
+
+TEST(Backpressure, AdaptiveRateUsesRingWatermarks) {
+  RingBuffer<int> rbuf(10);
+  rbuf.set_watermarks(2, 2);  // empty Elevated band: a step at 2
+  AdaptiveRateLimiter<int> limiter(rbuf, 1000, 100, 0.2);
+  rbuf.push(0);
+  limiter.try_acquire();
+  ASSERT_DOUBLE_EQ(limiter.current_rate(), 1000);
+  rbuf.push(0);
+  limiter.try_acquire();
+  ASSERT_NEAR(limiter.current_rate(), 200, 1e-6);
+
+  // Moving the watermarks moves the limiter with them.
+  rbuf.set_watermarks(4, 8);
+  limiter.try_acquire();
+  ASSERT_DOUBLE_EQ(limiter.current_rate(), 1000);
+  for (int i = 0; i < 4; ++i) rbuf.push(0);
+  limiter.try_acquire();
+  ASSERT_NEAR(limiter.current_rate(), 600, 1e-6);
+}
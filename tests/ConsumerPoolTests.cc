@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <broker_system/ConsumerPool.h>
+
+TEST(ConsumerPool, ConstructorException) {
+  ASSERT_THROW(ConsumerPool<int>(nullptr, nullptr), std::invalid_argument);
+}
+
+TEST(ConsumerPool, ProcessesEverything) {
+  std::atomic<long> sum{0};
+  ConsumerPoolOptions options;
+  options.workers = 3;
+  ConsumerPool<int> pool([&](const int& msg, size_t) { sum += msg; },
+                         [](const int& msg) { return msg; }, options);
+
+  long expected = 0;
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_TRUE(pool.submit(i));
+    expected += i;
+  }
+  pool.stop();
+  ASSERT_EQ(sum, expected);
+  ASSERT_EQ(pool.processed(), 10000);
+  ASSERT_FALSE(pool.submit(1));
+}
+
+TEST(ConsumerPool, IdleWorkersStealFromHotKey) {
+  ConsumerPoolOptions options;
+  options.workers = 4;
+  options.queue_capacity = 256;
+  options.steal_batch = 8;
+  ConsumerPool<int> pool(
+      [](const int&, size_t) {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+      },
+      [](const int&) { return 0; }, options);
+
+  for (int i = 0; i < 2000; ++i) pool.submit(i);
+  pool.stop();
+
+  ASSERT_EQ(pool.processed(), 2000);
+  uint64_t stolen = 0;
+  for (size_t w = 1; w < pool.workers(); ++w) stolen += pool.stolen(w);
+  ASSERT_GT(stolen, 0);
+  ASSERT_EQ(pool.stolen(0), 0);
+}
+
+TEST(ConsumerPool, DrainsSharedRingBuffer) {
+  RingBuffer<int> source(16);
+  std::atomic<long> sum{0};
+  ConsumerPoolOptions options;
+  options.workers = 2;
+  ConsumerPool<int> pool([&](const int& msg, size_t) { sum += msg; },
+                         [](const int& msg) { return msg % 7; }, options);
+
+  std::thread producer([&]() {
+    for (int i = 1; i <= 1000; ++i) source.push(i);
+    source.close();
+  });
+  pool.drain(source);
+  producer.join();
+  pool.stop();
+  ASSERT_EQ(sum, 500500);
+}
+
+// Submitters racing stop(): every accepted message is processed and no
+// submit hangs on a full queue.
+TEST(ConsumerPool, SubmitRacingStopIsNeverLost) {
+  for (int round = 0; round < 20; ++round) {
+    ConsumerPoolOptions options;
+    options.workers = 2;
+    options.queue_capacity = 2;
+    ConsumerPool<int> pool([](const int&, size_t) {}, nullptr, options);
+
+    std::atomic<uint64_t> accepted{0};
+    std::vector<std::thread> submitters;
+    for (int s = 0; s < 2; ++s) {
+      submitters.emplace_back([&]() {
+        while (pool.submit(1)) ++accepted;
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    pool.stop();
+    for (auto& t : submitters) t.join();
+    ASSERT_EQ(pool.processed(), accepted.load());
+  }
+}
+
+// A handler fanning out into its own full queue must not livelock: with a
+// single worker nobody else could ever drain it.
+TEST(ConsumerPool, HandlerSubmitIntoFullQueue) {
+  ConsumerPoolOptions options;
+  options.workers = 1;
+  options.queue_capacity = 4;
+  std::atomic<int> children{0};
+  ConsumerPool<int>* self = nullptr;
+  ConsumerPool<int> pool(
+      [&](const int& msg, size_t) {
+        if (msg == 0) {
+          for (int i = 0; i < 100; ++i) self->submit(1);
+        } else {
+          ++children;
+        }
+      },
+      nullptr, options);
+  self = &pool;
+
+  ASSERT_TRUE(pool.submit(0));
+  // stop() would reject the handler's submits, so wait for them first.
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (pool.processed() < 101 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(children, 100);
+  pool.stop();
+  ASSERT_EQ(pool.processed(), 101);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+
+#include <broker_system/Executor.h>
+#include <broker_system/RingBuffer.h>
+
+using namespace std::chrono_literals;
+
+static DetachedTask pop_into(RingBuffer<int>& rbuf, std::optional<int>& out,
+                             std::atomic<bool>& done) {
+  out = co_await rbuf.async_pop();
+  done = true;
+}
+
+static DetachedTask push_value(RingBuffer<int>& rbuf, int value, bool& ok,
+                               std::atomic<bool>& done) {
+  ok = co_await rbuf.async_push(value);
+  done = true;
+}
+
+static DetachedTask pool_consumer(RingBuffer<int>& rbuf, Executor& executor,
+                                  std::atomic<long>& sum,
+                                  std::atomic<int>& finished) {
+  co_await ScheduleOn{executor};
+  std::optional<int> msg = co_await rbuf.async_pop(executor);
+  if (msg) sum += *msg;
+  ++finished;
+}
+
+static DetachedTask pool_producer(RingBuffer<int>& rbuf, Executor& executor,
+                                  int value, std::atomic<int>& finished) {
+  co_await ScheduleOn{executor};
+  co_await rbuf.async_push(value, executor);
+  ++finished;
+}
+
+static bool wait_for(const std::atomic<int>& counter, int expected) {
+  auto deadline = std::chrono::steady_clock::now() + 10s;
+  while (counter < expected) {
+    if (std::chrono::steady_clock::now() > deadline) return false;
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+TEST(Coroutine, AsyncPopReadyValue) {
+  RingBuffer<int> rbuf(3);
+  rbuf.push(7);
+  std::optional<int> out;
+  std::atomic<bool> done{false};
+  pop_into(rbuf, out, done);
+  ASSERT_TRUE(done);
+  ASSERT_EQ(out, 7);
+  ASSERT_TRUE(rbuf.empty());
+}
+
+TEST(Coroutine, AsyncPopSuspendsUntilPush) {
+  RingBuffer<int> rbuf(3);
+  std::optional<int> out;
+  std::atomic<bool> done{false};
+  pop_into(rbuf, out, done);
+  ASSERT_FALSE(done);
+
+  rbuf.push(11);
+  ASSERT_TRUE(done);
+  ASSERT_EQ(out, 11);
+  ASSERT_TRUE(rbuf.empty());
+}
+
+TEST(Coroutine, AsyncPushSuspendsWhenFull) {
+  RingBuffer<int> rbuf(1);
+  rbuf.push(1);
+  bool ok = false;
+  std::atomic<bool> done{false};
+  push_value(rbuf, 2, ok, done);
+  ASSERT_FALSE(done);
+
+  int msg;
+  rbuf.pop(msg);
+  ASSERT_EQ(msg, 1);
+  ASSERT_TRUE(done);
+  ASSERT_TRUE(ok);
+  rbuf.pop(msg);
+  ASSERT_EQ(msg, 2);
+}
+
+TEST(Coroutine, CloseResumesWaiters) {
+  RingBuffer<int> empty(1);
+  std::optional<int> out = 0;
+  std::atomic<bool> pop_done{false};
+  pop_into(empty, out, pop_done);
+
+  RingBuffer<int> full(1);
+  full.push(0);
+  bool ok = true;
+  std::atomic<bool> push_done{false};
+  push_value(full, 1, ok, push_done);
+
+  empty.close();
+  full.close();
+  ASSERT_TRUE(pop_done);
+  ASSERT_EQ(out, std::nullopt);
+  ASSERT_TRUE(push_done);
+  ASSERT_FALSE(ok);
+}
+
+TEST(Coroutine, ThousandsOfTasksOnFewThreads) {
+  RingBuffer<int> rbuf(8);
+  ThreadPoolExecutor executor(2);
+  std::atomic<long> sum{0};
+  std::atomic<int> consumed{0}, produced{0};
+  const int tasks = 2000;
+
+  for (int i = 0; i < tasks; ++i) {
+    pool_consumer(rbuf, executor, sum, consumed);
+  }
+  for (int i = 1; i <= tasks; ++i) {
+    pool_producer(rbuf, executor, i, produced);
+  }
+
+  ASSERT_TRUE(wait_for(produced, tasks));
+  ASSERT_TRUE(wait_for(consumed, tasks));
+  ASSERT_EQ(sum, static_cast<long>(tasks) * (tasks + 1) / 2);
+  executor.stop();
+}
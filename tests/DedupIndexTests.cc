@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <broker_system/DedupIndex.h>
+#include <broker_system/VideoEvent.h>
+
+TEST(DedupIndex, InOrderAccepted) {
+  DedupIndex index;
+  for (uint64_t seq = 1; seq <= 1000; ++seq) {
+    ASSERT_TRUE(index.accept(1, seq));
+  }
+  ASSERT_EQ(index.high_water_mark(1), 1000);
+  ASSERT_EQ(index.duplicates(), 0);
+}
+
+TEST(DedupIndex, RetriedDuplicatesRejected) {
+  DedupIndex index;
+  for (uint64_t seq = 1; seq <= 10; ++seq) index.accept(1, seq);
+  for (uint64_t seq = 5; seq <= 10; ++seq) {
+    ASSERT_FALSE(index.accept(1, seq));
+  }
+  ASSERT_EQ(index.duplicates(), 6);
+  ASSERT_TRUE(index.accept(1, 11));
+}
+
+TEST(DedupIndex, OutOfOrderWithinWindow) {
+  DedupIndex index;
+  ASSERT_TRUE(index.accept(7, 10));
+  ASSERT_TRUE(index.accept(7, 8));
+  ASSERT_TRUE(index.accept(7, 9));
+  ASSERT_FALSE(index.accept(7, 8));
+  ASSERT_TRUE(index.accept(7, 70));
+  ASSERT_TRUE(index.accept(7, 20));
+  ASSERT_FALSE(index.accept(7, 6));
+}
+
+TEST(DedupIndex, ProducersAreIndependent) {
+  DedupIndex index;
+  ASSERT_TRUE(index.accept(1, 1));
+  ASSERT_TRUE(index.accept(2, 1));
+  ASSERT_FALSE(index.accept(1, 1));
+  ASSERT_EQ(index.high_water_mark(3), 0);
+}
+
+TEST(DedupIndex, PushOnceDropsRetries) {
+  RingBuffer<VideoEvent> ring(100);
+  DedupIndex index;
+  std::atomic<int> accepted{0};
+
+  auto producer = [&](uint32_t id) {
+    for (uint64_t seq = 1; seq <= 20; ++seq) {
+      VideoEvent event;
+      event.producer_id = id;
+      event.sequence = seq;
+      // Every event is sent twice, as after a reconnect.
+      for (int attempt = 0; attempt < 2; ++attempt) {
+        if (push_once(ring, index, event) == PushResult::Accepted) ++accepted;
+      }
+    }
+  };
+  std::thread t1(producer, 1);
+  std::thread t2(producer, 2);
+  t1.join();
+  t2.join();
+
+  ASSERT_EQ(accepted, 40);
+  ASSERT_EQ(ring.size(), 40);
+  ASSERT_EQ(index.duplicates(), 40);
+
+  VideoEvent unsequenced;
+  ASSERT_EQ(push_once(ring, index, unsequenced), PushResult::Accepted);
+  ring.close();
+  VideoEvent event;
+  event.producer_id = 9;
+  event.sequence = 1;
+  ASSERT_EQ(push_once(ring, index, event), PushResult::Closed);
+}
+
+TEST(DedupIndex, RetryAfterClosedRingIsAccepted) {
+  DedupIndex index;
+  RingBuffer<VideoEvent> closed_ring(4);
+  closed_ring.close();
+  VideoEvent event;
+  event.producer_id = 3;
+  event.sequence = 1;
+  ASSERT_EQ(push_once(closed_ring, index, event), PushResult::Closed);
+
+  RingBuffer<VideoEvent> open_ring(4);
+  ASSERT_EQ(push_once(open_ring, index, event), PushResult::Accepted);
+  ASSERT_EQ(push_once(open_ring, index, event), PushResult::Duplicate);
+  ASSERT_EQ(open_ring.size(), 1);
+}
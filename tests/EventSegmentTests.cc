@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <broker_system/EventSegment.h>
+#include <broker_system/LoadGenerator.h>
+
+static std::vector<VideoEvent> make_events(size_t n) {
+  LoadProfile profile;
+  profile.mix.watch = 30;
+  EventStream stream(profile, 0);
+  std::vector<VideoEvent> events;
+  stream.next_batch(events, n);
+  return events;
+}
+
+static bool same(const VideoEvent& a, const VideoEvent& b) {
+  return a.timestamp_ms == b.timestamp_ms && a.sequence == b.sequence &&
+         a.producer_id == b.producer_id && a.user_id == b.user_id &&
+         a.video_id == b.video_id && a.watch_ms == b.watch_ms &&
+         a.creator_id == b.creator_id && a.type == b.type;
+}
+
+TEST(EventSegment, RoundTripAcrossBlocks) {
+  auto events = make_events(10000);
+  std::stringstream segment;
+  SegmentOptions options;
+  options.block_events = 1024;
+  {
+    SegmentWriter writer(segment, options);
+    writer.append(events.data(), events.size());
+    writer.flush();
+    ASSERT_EQ(writer.events(), events.size());
+    ASSERT_EQ(writer.bytes(), segment.str().size());
+    // Columnar delta + varint alone beats the raw structs by far.
+    ASSERT_LT(writer.bytes() * 3, events.size() * sizeof(VideoEvent));
+  }
+
+  SegmentReader reader(segment);
+  std::vector<VideoEvent> restored;
+  size_t blocks = 0;
+  while (size_t n = reader.next_block(restored)) {
+    ASSERT_LE(n, options.block_events);
+    ++blocks;
+  }
+  ASSERT_EQ(blocks, 10);
+  ASSERT_EQ(restored.size(), events.size());
+  for (size_t i = 0; i < events.size(); ++i) ASSERT_TRUE(same(restored[i], events[i])) << i;
+}
+
+TEST(EventSegment, StreamingNext) {
+  std::vector<VideoEvent> events(3);
+  events[0].timestamp_ms = 100;
+  events[0].sequence = UINT64_MAX;
+  events[1].timestamp_ms = 50;  // going backwards is just a negative delta
+  events[1].video_id = 999;
+  events[2].type = EventType::WatchDuration;
+  events[2].watch_ms = 600000;
+
+  std::stringstream segment;
+  SegmentOptions options;
+  options.block_events = 2;
+  SegmentWriter(segment, options).append(events.data(), events.size());
+
+  SegmentReader reader(segment);
+  VideoEvent event;
+  for (const VideoEvent& expected : events) {
+    ASSERT_TRUE(reader.next(event));
+    ASSERT_TRUE(same(event, expected));
+  }
+  ASSERT_FALSE(reader.next(event));
+}
+
+TEST(EventSegment, CorruptData) {
+  std::stringstream bad_magic("XXXX\x01");
+  ASSERT_THROW(SegmentReader{bad_magic}, std::runtime_error);
+
+  auto events = make_events(100);
+  std::stringstream segment;
+  SegmentWriter(segment, {}).append(events.data(), events.size());
+  std::string bytes = segment.str();
+  std::stringstream truncated(bytes.substr(0, bytes.size() - 10));
+  SegmentReader reader(truncated);
+  std::vector<VideoEvent> out;
+  ASSERT_THROW(reader.next_block(out), std::runtime_error);
+
+  // Byte 12 of the first block header (after the 5-byte file header) is
+  // the codec; an unknown value is corruption, not a missing codec.
+  std::string bad_codec_bytes = bytes;
+  bad_codec_bytes[5 + 12] = 9;
+  std::stringstream bad_codec(bad_codec_bytes);
+  SegmentReader bad_codec_reader(bad_codec);
+  try {
+    bad_codec_reader.next_block(out);
+    FAIL() << "unknown codec accepted";
+  } catch (const std::runtime_error& e) {
+    ASSERT_STREQ(e.what(), ERROR_SEGMENT_CORRUPT);
+  }
+}
+
+TEST(EventSegment, Codecs) {
+  auto events = make_events(5000);
+  for (SegmentCodec codec : {SegmentCodec::Lz4, SegmentCodec::Zstd}) {
+    SegmentOptions options;
+    options.codec = codec;
+    std::stringstream segment;
+    if (!codec_available(codec)) {
+      ASSERT_THROW(SegmentWriter(segment, options), std::invalid_argument);
+      continue;
+    }
+    SegmentWriter(segment, options).append(events.data(), events.size());
+    SegmentReader reader(segment);
+    std::vector<VideoEvent> restored;
+    while (reader.next_block(restored)) {}
+    ASSERT_EQ(restored.size(), events.size());
+    ASSERT_TRUE(same(restored.back(), events.back()));
+  }
+}
+
+TEST(EventSegment, CheckpointRestoreRingBuffer) {
+  RingBuffer<VideoEvent> ring(64);
+  auto events = make_events(100);
+  VideoEvent dropped;
+  for (size_t i = 0; i < 40; ++i) ring.push(events[i]);
+  for (size_t i = 0; i < 10; ++i) ring.pop(dropped);
+  for (size_t i = 40; i < 70; ++i) ring.push(events[i]);  // wraps around
+
+  std::stringstream checkpoint_data;
+  ASSERT_EQ(checkpoint(ring, checkpoint_data), 60);
+
+  RingBuffer<VideoEvent> recovered(64);
+  ASSERT_EQ(restore(checkpoint_data, recovered), 60);
+  VideoEvent event;
+  for (size_t i = 10; i < 70; ++i) {
+    ASSERT_TRUE(recovered.try_pop(event));
+    ASSERT_TRUE(same(event, events[i]));
+  }
+  ASSERT_TRUE(recovered.empty());
+}
+
+TEST(EventSegment, CheckpointWhileProducing) {
+  RingBuffer<VideoEvent> ring(256);
+  std::atomic<bool> done{false};
+  std::thread producer([&]() {
+    uint64_t sequence = 0;
+    VideoEvent event;
+    while (!done) {
+      event.sequence = ++sequence;
+      if (!ring.try_push(event)) {
+        VideoEvent dropped;
+        ring.try_pop(dropped);
+      }
+    }
+  });
+
+  for (int round = 0; round < 20; ++round) {
+    std::stringstream data;
+    size_t written = checkpoint(ring, data);
+    SegmentReader reader(data);
+    std::vector<VideoEvent> restored;
+    while (reader.next_block(restored)) {}
+    ASSERT_EQ(restored.size(), written);
+    for (size_t i = 1; i < restored.size(); ++i) {
+      ASSERT_EQ(restored[i].sequence, restored[i - 1].sequence + 1);
+    }
+  }
+  done = true;
+  producer.join();
+}
+
+// Accepts the segment header, then fails every write.
+class FullDiskBuf : public std::streambuf {
+ protected:
+  std::streamsize xsputn(const char*, std::streamsize n) override {
+    written_ += n;
+    return written_ <= 5 ? n : 0;
+  }
+  int_type overflow(int_type c) override {
+    return ++written_ <= 5 ? c : traits_type::eof();
+  }
+
+ private:
+  std::streamsize written_ = 0;
+};
+
+TEST(EventSegment, DestructorSwallowsStreamErrors) {
+  FullDiskBuf buf;
+  std::ostream sink(&buf);
+  sink.exceptions(std::ios::badbit);
+  {
+    SegmentWriter writer(sink);
+    writer.append(VideoEvent{});
+    ASSERT_THROW(writer.flush(), std::ios::failure);
+  }
+
+  FullDiskBuf other_buf;
+  std::ostream other(&other_buf);
+  other.exceptions(std::ios::badbit);
+  auto writer = std::make_unique<SegmentWriter>(other);
+  writer->append(VideoEvent{});
+  ASSERT_NO_THROW(writer.reset());
+}
+
+TEST(EventSegment, WriteErrorsThrow) {
+  RingBuffer<VideoEvent> ring(4);
+  ring.push(VideoEvent{});
+  std::ofstream unopened("/nonexistent-dir/segment.bin");
+  ASSERT_THROW(checkpoint(ring, unopened), std::runtime_error);
+
+  FullDiskBuf buf;
+  std::ostream sink(&buf);
+  SegmentWriter writer(sink);
+  writer.append(VideoEvent{});
+  ASSERT_THROW(writer.flush(), std::runtime_error);
+  ASSERT_EQ(writer.events(), 0);
+}
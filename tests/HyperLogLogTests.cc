@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <thread>
+
+#include <broker_system/HyperLogLog.h>
+
+static double relative_error(double estimate, double exact) {
+  return std::abs(estimate - exact) / exact;
+}
+
+TEST(HyperLogLog, EmptyIsZero) {
+  HyperLogLog hll;
+  ASSERT_DOUBLE_EQ(hll.estimate(), 0.0);
+}
+
+TEST(HyperLogLog, SmallCardinality) {
+  HyperLogLog hll;
+  for (uint64_t user = 0; user < 100; ++user) hll.add(user);
+  ASSERT_LT(relative_error(hll.estimate(), 100), 0.05);
+}
+
+TEST(HyperLogLog, LargeCardinality) {
+  HyperLogLog hll;
+  for (uint64_t user = 0; user < 1000000; ++user) hll.add(user);
+  ASSERT_LT(relative_error(hll.estimate(), 1000000), 0.05);
+}
+
+TEST(HyperLogLog, DuplicatesIgnored) {
+  HyperLogLog hll;
+  for (int round = 0; round < 10; ++round) {
+    for (uint64_t user = 0; user < 5000; ++user) hll.add(user);
+  }
+  ASSERT_LT(relative_error(hll.estimate(), 5000), 0.05);
+}
+
+TEST(HyperLogLog, MergeEqualsUnion) {
+  HyperLogLog left, right, all;
+  for (uint64_t user = 0; user < 60000; ++user) {
+    (user % 2 ? left : right).add(user);
+    all.add(user);
+  }
+  left.merge(right);
+  ASSERT_EQ(left.registers(), all.registers());
+}
+
+TEST(DistinctViewers, FixedMemoryPerKey) {
+  ASSERT_EQ(sizeof(HyperLogLog), HyperLogLog::kRegisters);
+}
+
+TEST(DistinctViewers, RunRejectsZeroBatch) {
+  DistinctViewers viewers;
+  RingBuffer<VideoEvent> source(4);
+  source.push(VideoEvent{});
+  ASSERT_THROW(viewers.run(source, 0), std::invalid_argument);
+  ASSERT_EQ(source.size(), 1);
+}
+
+TEST(DistinctViewers, PartitionedConsumersMerge) {
+  DistinctViewers part1, part2;
+  RingBuffer<VideoEvent> ring1(256), ring2(256);
+
+  std::thread c1([&]() { part1.run(ring1, 64); });
+  std::thread c2([&]() { part2.run(ring2, 64); });
+  for (uint32_t user = 0; user < 20000; ++user) {
+    VideoEvent event;
+    event.user_id = user;
+    event.video_id = user % 2;
+    event.creator_id = creator_of(event.video_id);
+    (user % 4 < 2 ? ring1 : ring2).push(event);
+  }
+  ring1.close();
+  ring2.close();
+  c1.join();
+  c2.join();
+
+  part1.merge(part2);
+  ASSERT_LT(relative_error(part1.video_estimate(0), 10000), 0.05);
+  ASSERT_LT(relative_error(part1.video_estimate(1), 10000), 0.05);
+  ASSERT_LT(relative_error(part1.creator_estimate(0), 10000), 0.05);
+  ASSERT_DOUBLE_EQ(part1.video_estimate(2), 0.0);
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <broker_system/LoadGenerator.h>
+
+static bool same_event(const VideoEvent& a, const VideoEvent& b) {
+  return a.timestamp_ms == b.timestamp_ms && a.sequence == b.sequence &&
+         a.producer_id == b.producer_id && a.user_id == b.user_id &&
+         a.video_id == b.video_id && a.watch_ms == b.watch_ms &&
+         a.creator_id == b.creator_id && a.type == b.type;
+}
+
+TEST(LoadGenerator, ProfileException) {
+  LoadProfile profile;
+  profile.threads = 0;
+  ASSERT_THROW(LoadGenerator generator(profile), std::invalid_argument);
+}
+
+TEST(LoadGenerator, DeterministicSeed) {
+  LoadProfile profile;
+  profile.seed = 7;
+  EventStream a(profile, 0), b(profile, 0), other(profile, 1);
+
+  bool differs = false;
+  for (int i = 0; i < 1000; ++i) {
+    VideoEvent ea = a.next(), eb = b.next(), eo = other.next();
+    ASSERT_TRUE(same_event(ea, eb));
+    differs |= !same_event(ea, eo);
+  }
+  ASSERT_TRUE(differs);
+}
+
+TEST(LoadGenerator, ZipfPopularityAndMix) {
+  LoadProfile profile;
+  EventStream stream(profile, 0);
+  std::vector<uint64_t> per_video(kVideoCount, 0);
+  std::array<uint64_t, kEventTypeCount> per_type{};
+  const int total = 200000;
+
+  for (int i = 0; i < total; ++i) {
+    VideoEvent event = stream.next();
+    ASSERT_LT(event.video_id, kVideoCount);
+    ASSERT_LT(event.user_id, kUserCount);
+    ASSERT_EQ(event.creator_id, creator_of(event.video_id));
+    ++per_video[event.video_id];
+    ++per_type[static_cast<size_t>(event.type)];
+  }
+
+  // With s = 1 rank 1 gets about 1 / H(1000) ~ 13% of the traffic.
+  ASSERT_NEAR(per_video[0] / double(total), 0.134, 0.01);
+  ASSERT_GT(per_video[0], per_video[1]);
+  ASSERT_GT(per_video[1], per_video[100]);
+  ASSERT_NEAR(per_type[0] / double(total), 0.70, 0.01);
+  ASSERT_NEAR(per_type[1] / double(total), 0.12, 0.01);
+}
+
+TEST(LoadGenerator, BurstTargetsOneVideo) {
+  LoadProfile profile;
+  profile.burst_probability = 1.0;
+  EventStream stream(profile, 0);
+  std::vector<VideoEvent> batch;
+  ASSERT_TRUE(stream.next_batch(batch, 32));
+  for (auto& event : batch) ASSERT_EQ(event.video_id, batch[0].video_id);
+}
+
+TEST(LoadGenerator, IntoRingBuffer) {
+  LoadProfile profile;
+  profile.threads = 3;
+  profile.events = 10000;
+  LoadGenerator generator(profile);
+  RingBuffer<VideoEvent> ring(128);
+
+  // The consumer only records; asserting there would stop it early and
+  // leave the producers blocked on the full ring.
+  std::vector<uint64_t> last_seq(profile.threads + 1, 0);
+  uint64_t received = 0;
+  uint64_t out_of_order = 0;
+  std::thread consumer([&]() {
+    std::vector<VideoEvent> batch;
+    while (ring.pop_bulk(batch, 64) != 0) {
+      for (auto& event : batch) {
+        if (event.producer_id >= last_seq.size() ||
+            event.sequence != last_seq[event.producer_id] + 1) {
+          ++out_of_order;
+          continue;
+        }
+        last_seq[event.producer_id] = event.sequence;
+      }
+      received += batch.size();
+      batch.clear();
+    }
+  });
+
+  LoadStats stats = generator.run(ring);
+  ring.close();
+  consumer.join();
+  ASSERT_EQ(stats.events, 10000);
+  ASSERT_EQ(received, 10000);
+  ASSERT_EQ(out_of_order, 0);
+}
+
+TEST(LoadGenerator, TargetRate) {
+  LoadProfile profile;
+  profile.threads = 2;
+  profile.events = 2000;
+  profile.events_per_second = 20000;
+  profile.batch_size = 50;
+  LoadGenerator generator(profile);
+
+  LoadStats stats = generator.run([](size_t) -> EventSink {
+    return [](const VideoEvent*, size_t) { return true; };
+  });
+  ASSERT_EQ(stats.events, 2000);
+  ASSERT_GE(stats.seconds, 0.09);
+  ASSERT_LT(stats.events_per_second, 22000);
+}
+
+TEST(LoadGenerator, OverLoopback) {
+  int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+  ::listen(listener, 1);
+  socklen_t len = sizeof(addr);
+  ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len);
+
+  std::string bytes;
+  std::thread server([&]() {
+    int client = ::accept(listener, nullptr, nullptr);
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::recv(client, buf, sizeof(buf), 0)) > 0) bytes.append(buf, n);
+    ::close(client);
+  });
+
+  LoadProfile profile;
+  profile.events = 5000;
+  LoadGenerator generator(profile);
+  LoadStats stats = generator.run(loopback_sink("127.0.0.1", ntohs(addr.sin_port)));
+  server.join();
+  ::close(listener);
+
+  ASSERT_EQ(stats.events, 5000);
+  ASSERT_EQ(bytes.size(), 5000 * kEventWireSize);
+  for (size_t i = 0; i < 5000; ++i) {
+    ASSERT_EQ(decode_event(bytes.data() + i * kEventWireSize).sequence, i + 1);
+  }
+}
+
+TEST(LoadGenerator, WireFormatIsFixedLittleEndian) {
+  VideoEvent event;
+  event.timestamp_ms = 0x0102030405060708ULL;
+  event.sequence = 42;
+  event.producer_id = 7;
+  event.user_id = 0xAABBCCDD;
+  event.video_id = 999;
+  event.watch_ms = 123456;
+  event.creator_id = 9;
+  event.type = EventType::WatchDuration;
+
+  std::array<char, kEventWireSize> wire;
+  encode_event(event, wire.data());
+  ASSERT_EQ(static_cast<uint8_t>(wire[0]), 0x08);
+  ASSERT_EQ(static_cast<uint8_t>(wire[7]), 0x01);
+  ASSERT_EQ(static_cast<uint8_t>(wire[20]), 0xDD);
+  ASSERT_EQ(static_cast<uint8_t>(wire[32]), 9);
+  ASSERT_EQ(static_cast<uint8_t>(wire[33]), static_cast<uint8_t>(EventType::WatchDuration));
+  ASSERT_TRUE(same_event(decode_event(wire.data()), event));
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <broker_system/LockFreeRingBuffer.h>
+
+TEST(LockFree, ConstructorException) {
+  try {
+    LockFreeRingBuffer<int> rbuf(0);
+    FAIL();
+  } catch (std::invalid_argument& e) {
+    ASSERT_EQ(std::string(ERROR_RINGBUF_SIZE), e.what());
+  }
+}
+
+TEST(LockFree, PushPopFull) {
+  LockFreeRingBuffer<int> rbuf(4);
+  ASSERT_EQ(rbuf.capacity(), 4);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(rbuf.try_push(i));
+  }
+  ASSERT_FALSE(rbuf.try_push(4));
+
+  int msg;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(rbuf.try_pop(msg));
+    ASSERT_EQ(msg, i);
+  }
+  ASSERT_FALSE(rbuf.try_pop(msg));
+  ASSERT_TRUE(rbuf.empty());
+}
+
+TEST(LockFree, PopBulk) {
+  LockFreeRingBuffer<int> rbuf(8);
+  for (int i = 0; i < 5; ++i) rbuf.try_push(i);
+
+  std::vector<int> out;
+  ASSERT_EQ(rbuf.try_pop_bulk(out, 3), 3);
+  ASSERT_EQ(out, std::vector<int>({0, 1, 2}));
+  ASSERT_EQ(rbuf.try_pop_bulk(out, 10), 2);
+  ASSERT_EQ(out.size(), 5);
+}
+
+TEST(LockFree, ManyProducersManyConsumers) {
+  LockFreeRingBuffer<int> rbuf(64);
+  const int per_producer = 20000;
+  const int producers = 3, consumers = 3;
+  std::atomic<long> push_sum{0}, pop_sum{0};
+  std::atomic<int> popped{0};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (int i = 0; i < per_producer; ++i) {
+        int val = p * per_producer + i;
+        while (!rbuf.try_push(val)) std::this_thread::yield();
+        push_sum += val;
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&]() {
+      int msg;
+      while (popped < producers * per_producer) {
+        if (rbuf.try_pop(msg)) {
+          pop_sum += msg;
+          ++popped;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  ASSERT_EQ(popped, producers * per_producer);
+  ASSERT_EQ(push_sum, pop_sum);
+}
+
+TEST(LockFree, PopBulkWrapsAndConcurrentClaims) {
+  LockFreeRingBuffer<int> rbuf(8);
+  std::vector<int> out;
+  for (int i = 0; i < 6; ++i) rbuf.try_push(i);
+  ASSERT_EQ(rbuf.try_pop_bulk(out, 4), 4);
+  for (int i = 6; i < 12; ++i) ASSERT_TRUE(rbuf.try_push(i));
+  ASSERT_EQ(rbuf.try_pop_bulk(out, 100), 8);  // the claim wraps around
+  ASSERT_EQ(out, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+  ASSERT_EQ(rbuf.try_pop_bulk(out, 4), 0);
+
+  // Bulk claims from several threads never hand out a message twice.
+  LockFreeRingBuffer<int> shared(64);
+  const int total = 50000;
+  std::atomic<long> pop_sum{0};
+  std::atomic<int> popped{0};
+  std::vector<std::thread> threads;
+  threads.emplace_back([&]() {
+    for (int i = 1; i <= total; ++i) {
+      while (!shared.try_push(i)) std::this_thread::yield();
+    }
+  });
+  for (int c = 0; c < 3; ++c) {
+    threads.emplace_back([&]() {
+      std::vector<int> batch;
+      while (popped.load() < total) {
+        batch.clear();
+        size_t n = shared.try_pop_bulk(batch, 7);
+        for (int v : batch) pop_sum += v;
+        popped += static_cast<int>(n);
+        if (n == 0) std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  ASSERT_EQ(popped, total);
+  ASSERT_EQ(pop_sum, static_cast<long>(total) * (total + 1) / 2);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+
+static_assert(std::is_same_v<RingBuffer<int>, RingBuffer<int, Mutex>>);
+
+TEST(LockPolicy, NoLockSingleThread) {
+  RingBuffer<int, NoLock> rbuf(4);
+  for (int i = 0; i < 4; ++i) ASSERT_TRUE(rbuf.push(i));
+  ASSERT_TRUE(rbuf.full());
+  ASSERT_FALSE(rbuf.try_push(4));
+  ASSERT_EQ(rbuf.size(), 4);
+
+  std::vector<int> out;
+  ASSERT_EQ(rbuf.pop_bulk(out, 3), 3);
+  int val;
+  ASSERT_TRUE(rbuf.pop(val));
+  ASSERT_EQ(val, 3);
+  ASSERT_EQ(out, (std::vector<int>{0, 1, 2}));
+  ASSERT_TRUE(rbuf.empty());
+}
+
+TEST(LockPolicy, NoLockWouldBlock) {
+  RingBuffer<int, NoLock> rbuf(1);
+  int val;
+  ASSERT_THROW(rbuf.pop(val), std::logic_error);
+  ASSERT_FALSE(rbuf.pop_for(val, std::chrono::seconds(10)));
+
+  rbuf.push(1);
+  ASSERT_THROW(rbuf.push(2), std::logic_error);
+  ASSERT_FALSE(rbuf.push_for(2, std::chrono::seconds(10)));
+
+  rbuf.close();
+  ASSERT_FALSE(rbuf.push(2));
+  ASSERT_TRUE(rbuf.pop(val));
+  ASSERT_FALSE(rbuf.pop(val));
+}
+
+TEST(LockPolicy, SpinLockProducersConsumers) {
+  RingBuffer<int, SpinLock> rbuf(8);
+  std::atomic<long> sum{0};
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < 2; ++c) {
+    consumers.emplace_back([&]() {
+      int val;
+      while (rbuf.pop(val)) sum += val;
+    });
+  }
+  std::vector<std::thread> producers;
+  for (int p = 0; p < 2; ++p) {
+    producers.emplace_back([&]() {
+      for (int i = 1; i <= 5000; ++i) rbuf.push(i);
+    });
+  }
+  for (auto& t : producers) t.join();
+  rbuf.close();
+  for (auto& t : consumers) t.join();
+  ASSERT_EQ(sum, 2L * 5000 * 5001 / 2);
+  ASSERT_TRUE(rbuf.closed());
+}
+
+TEST(LockPolicy, GettersWhileLocked) {
+  RingBuffer<int> rbuf(4);
+  rbuf.push(1);
+  rbuf.push(2);
+  // Getters never lock, so a pressure callback (run under the lock) may use them.
+  size_t seen = 0;
+  rbuf.set_watermarks(1, 3, [&](PressureLevel) { seen = rbuf.size() + rbuf.capacity(); });
+  rbuf.push(3);
+  ASSERT_EQ(seen, 3 + 4);
+  ASSERT_EQ(rbuf.snapshot(), std::make_tuple(size_t{3}, size_t{1}, size_t{4}));
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <broker_system/LossyRingBuffer.h>
+
+TEST(LossyRingBuffer, ConstructorException) {
+  ASSERT_THROW(LossyRingBuffer<int>(0), std::invalid_argument);
+  ASSERT_EQ(LossyRingBuffer<int>(5).capacity(), 8);
+}
+
+TEST(LossyRingBuffer, FifoWithoutOverwrite) {
+  LossyRingBuffer<int> rbuf(4);
+  for (int i = 0; i < 4; ++i) rbuf.push(i);
+  ASSERT_EQ(rbuf.size(), 4);
+  int msg;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(rbuf.try_pop(msg));
+    ASSERT_EQ(msg, i);
+  }
+  ASSERT_FALSE(rbuf.try_pop(msg));
+  ASSERT_EQ(rbuf.overwritten(), 0);
+  ASSERT_EQ(rbuf.lost(), 0);
+}
+
+TEST(LossyRingBuffer, OverwritesOldest) {
+  LossyRingBuffer<int> rbuf(4);
+  for (int i = 0; i < 10; ++i) rbuf.push(i);
+  ASSERT_EQ(rbuf.overwritten(), 6);
+  ASSERT_EQ(rbuf.size(), 4);
+
+  std::vector<int> out;
+  ASSERT_EQ(rbuf.try_pop_bulk(out, 16), 3);
+  // Skipping ahead leaves one extra slot of margin for the producer.
+  ASSERT_EQ(out, (std::vector<int>{7, 8, 9}));
+  ASSERT_EQ(rbuf.lost(), 7);
+  ASSERT_TRUE(rbuf.empty());
+
+  rbuf.push(10);
+  int msg;
+  ASSERT_TRUE(rbuf.try_pop(msg));
+  ASSERT_EQ(msg, 10);
+}
+
+struct Sample {
+  uint64_t a, b, c;
+};
+
+TEST(LossyRingBuffer, SlowConsumerSeesNoTornSamples) {
+  constexpr uint64_t kCount = 200000;
+  LossyRingBuffer<Sample> rbuf(64);
+  std::atomic<bool> done{false};
+
+  std::thread producer([&]() {
+    for (uint64_t i = 1; i <= kCount; ++i) rbuf.push({i, i * 3, ~i});
+    done = true;
+  });
+
+  uint64_t received = 0;
+  uint64_t last = 0;
+  Sample sample;
+  while (true) {
+    bool finished = done.load();
+    if (rbuf.try_pop(sample)) {
+      ASSERT_GT(sample.a, last);
+      ASSERT_EQ(sample.b, sample.a * 3);
+      ASSERT_EQ(sample.c, ~sample.a);
+      last = sample.a;
+      ++received;
+      if (received % 64 == 0) std::this_thread::yield();
+    } else if (finished) {
+      break;
+    }
+  }
+  producer.join();
+
+  ASSERT_EQ(last, kCount);
+  ASSERT_EQ(received + rbuf.lost(), kCount);
+}
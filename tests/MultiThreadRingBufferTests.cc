@@ -11,7 +11,7 @@
 std::mutex cout_mtx;
 
 int gen_random_int(int min, int max) {
-  std::mt19937 gen(std::random_device{}());
+  thread_local std::mt19937 gen(std::random_device{}());
   std::uniform_int_distribution<> dist(min, max);
   return dist(gen); 
 }
@@ -105,12 +105,12 @@ TEST(MultiThread, ConcurrentStateChecks) {
       rbuf.push(i);
     }
     done = true;
+    rbuf.close();
   });
 
   std::thread reader([&]() {
     int val;
-    while (!done || !rbuf.empty()) {
-      rbuf.pop(val);
+    while (rbuf.pop(val)) {
       std::this_thread::sleep_for(std::chrono::microseconds(1));
     }
   });
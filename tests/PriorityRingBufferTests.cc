@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <broker_system/PriorityRingBuffer.h>
+
+using namespace std::chrono_literals;
+
+TEST(PriorityLanes, ConstructorException) {
+  ASSERT_THROW(PriorityRingBuffer<int>(LaneConfig{}), std::invalid_argument);
+  ASSERT_THROW(PriorityRingBuffer<int>(LaneConfig{.capacities = {4, 0}, .weights = {}}), std::invalid_argument);
+  PriorityRingBuffer<int> queue(LaneConfig{.capacities = {4}, .weights = {}});
+  ASSERT_THROW(queue.push(1, 1), std::out_of_range);
+}
+
+TEST(PriorityLanes, StrictPriority) {
+  LaneConfig config;
+  config.capacities = {10, 10};
+  config.starvation_limit = 0;
+  PriorityRingBuffer<int> queue(config);
+
+  for (int i = 0; i < 5; ++i) queue.push(100 + i, 1);
+  queue.push(1, 0);
+  queue.push(2, 0);
+
+  std::vector<int> out;
+  ASSERT_EQ(queue.pop_bulk(out, 10), 7);
+  ASSERT_EQ(out, std::vector<int>({1, 2, 100, 101, 102, 103, 104}));
+}
+
+TEST(PriorityLanes, UrgentMessageOvertakesFullLane) {
+  LaneConfig config;
+  config.capacities = {4, 1000};
+  PriorityRingBuffer<int> queue(config);
+  for (int i = 0; i < 1000; ++i) queue.push(i, 1);
+  ASSERT_FALSE(queue.try_push(0, 1));
+
+  ASSERT_TRUE(queue.try_push(-1, 0));
+  int msg;
+  ASSERT_TRUE(queue.pop(msg));
+  ASSERT_EQ(msg, -1);
+}
+
+TEST(PriorityLanes, WeightedRoundRobin) {
+  LaneConfig config;
+  config.capacities = {100, 100};
+  config.scheduling = LaneScheduling::WeightedRoundRobin;
+  config.weights = {3, 1};
+  PriorityRingBuffer<int> queue(config);
+  for (int i = 0; i < 40; ++i) {
+    queue.push(0, 0);
+    queue.push(1, 1);
+  }
+
+  std::vector<int> out;
+  queue.pop_bulk(out, 40);
+  int high = 0;
+  for (int lane : out) high += lane == 0;
+  ASSERT_EQ(high, 30);
+  ASSERT_EQ(std::vector<int>(out.begin(), out.begin() + 8),
+            std::vector<int>({0, 0, 0, 1, 0, 0, 0, 1}));
+}
+
+TEST(PriorityLanes, StarvationGuard) {
+  LaneConfig config;
+  config.capacities = {100, 100};
+  config.starvation_limit = 4;
+  PriorityRingBuffer<int> queue(config);
+  for (int i = 0; i < 20; ++i) queue.push(0, 0);
+  queue.push(1, 1);
+
+  std::vector<int> out;
+  queue.pop_bulk(out, 6);
+  ASSERT_EQ(out, std::vector<int>({0, 0, 0, 0, 1, 0}));
+}
+
+TEST(PriorityLanes, BlockingPushPerLane) {
+  LaneConfig config;
+  config.capacities = {1, 1};
+  PriorityRingBuffer<int> queue(config);
+  queue.push(10, 1);
+
+  std::thread producer([&]() { queue.push(11, 1); });
+  std::this_thread::sleep_for(5ms);
+  ASSERT_TRUE(queue.try_push(1, 0));
+
+  int msg;
+  queue.pop(msg);
+  ASSERT_EQ(msg, 1);
+  queue.pop(msg);
+  ASSERT_EQ(msg, 10);
+  producer.join();
+  queue.pop(msg);
+  ASSERT_EQ(msg, 11);
+}
+
+// Each pop wakes one producer of the lane it freed, and no wake-up is lost
+// with several producers blocked on every lane.
+TEST(PriorityLanes, PopWakesProducersOfItsLane) {
+  LaneConfig config;
+  config.capacities = {1, 1};
+  PriorityRingBuffer<int> queue(config);
+  queue.push(0, 0);
+  queue.push(100, 1);
+
+  std::atomic<int> pushed[2] = {0, 0};
+  std::vector<std::thread> producers;
+  for (size_t lane = 0; lane < 2; ++lane) {
+    for (int i = 0; i < 3; ++i) {
+      producers.emplace_back([&, lane]() {
+        if (queue.push(static_cast<int>(lane * 100), lane)) ++pushed[lane];
+      });
+    }
+  }
+  std::this_thread::sleep_for(5ms);
+  ASSERT_EQ(pushed[0] + pushed[1], 0);
+
+  // Strict priority keeps draining lane 0, so only its producers get in.
+  int msg;
+  for (int i = 0; i < 3; ++i) {
+    queue.pop(msg);
+    ASSERT_EQ(msg, 0);
+    while (pushed[0] != i + 1) std::this_thread::yield();
+  }
+  ASSERT_EQ(pushed[1], 0);
+  // Left: one message in each lane plus the three blocked lane 1 pushes.
+  for (int i = 0; i < 5; ++i) {
+    queue.pop(msg);
+  }
+  for (auto& producer : producers) producer.join();
+  ASSERT_EQ(pushed[1], 3);
+  ASSERT_EQ(queue.size(), 0);
+}
+
+TEST(PriorityLanes, CloseDrainsThenEndOfStream) {
+  PriorityRingBuffer<int> queue(LaneConfig{.capacities = {4, 4}, .weights = {}});
+  queue.push(1, 1);
+  queue.push(0, 0);
+  queue.close();
+  ASSERT_FALSE(queue.push(2, 0));
+
+  int msg;
+  ASSERT_TRUE(queue.pop(msg));
+  ASSERT_TRUE(queue.pop(msg));
+  ASSERT_FALSE(queue.pop(msg));
+  ASSERT_FALSE(queue.pop_for(msg, 1ms));
+}
+
+TEST(PriorityLanes, PopBulkZeroIsRejected) {
+  PriorityRingBuffer<int> queue(LaneConfig{.capacities = {4}, .weights = {}});
+  queue.push(1, 0);
+  std::vector<int> out;
+  ASSERT_THROW(queue.pop_bulk(out, 0), std::invalid_argument);
+  ASSERT_EQ(queue.pop_bulk(out, 4), 1);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <broker_system/RetainedLog.h>
+
+using namespace std::chrono_literals;
+
+TEST(RetainedLog, ConstructorException) {
+  ASSERT_THROW(RetainedLog<int>(RetentionPolicy{0, 0}), std::invalid_argument);
+}
+
+TEST(RetainedLog, OffsetsAreMonotonic) {
+  RetainedLog<int> log({8, 0});
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(log.append(i * 10), static_cast<uint64_t>(i));
+  }
+  ASSERT_EQ(log.begin_offset(), 0);
+  ASSERT_EQ(log.end_offset(), 5);
+
+  std::vector<int> out;
+  ASSERT_EQ(log.read(2, out, 10), 3);
+  ASSERT_EQ(out, std::vector<int>({20, 30, 40}));
+  ASSERT_THROW(log.read(6, out, 1), std::out_of_range);
+}
+
+TEST(RetainedLog, ReadingDoesNotConsume) {
+  RetainedLog<int> log({8, 0});
+  for (int i = 0; i < 3; ++i) log.append(i);
+
+  auto first = log.cursor(0);
+  auto second = log.cursor(0);
+  std::vector<int> a, b;
+  first.next(a, 10);
+  second.next(b, 10);
+  ASSERT_EQ(a, b);
+  ASSERT_EQ(log.size(), 3);
+}
+
+TEST(RetainedLog, CountRetentionEvictsOldest) {
+  RetainedLog<int> log({4, 0});
+  for (int i = 0; i < 10; ++i) log.append(i);
+  ASSERT_EQ(log.begin_offset(), 6);
+  ASSERT_EQ(log.size(), 4);
+
+  std::vector<int> out;
+  ASSERT_THROW(log.read(5, out, 1), std::out_of_range);
+  ASSERT_EQ(log.read(6, out, 10), 4);
+  ASSERT_EQ(out, std::vector<int>({6, 7, 8, 9}));
+}
+
+TEST(RetainedLog, ByteRetention) {
+  RetainedLog<std::string> log({100, 10},
+                               [](const std::string& s) { return s.size(); });
+  log.append("aaaa");
+  log.append("bbbb");
+  ASSERT_EQ(log.bytes(), 8);
+  log.append("cccc");
+  ASSERT_EQ(log.begin_offset(), 1);
+  ASSERT_EQ(log.bytes(), 8);
+  log.append("a very long message");
+  ASSERT_EQ(log.size(), 1);
+}
+
+TEST(RetainedLog, EvictionReleasesPayloads) {
+  auto payload = std::make_shared<std::string>(64 * 1024, 'x');
+  RetainedLog<std::shared_ptr<std::string>> by_bytes({1024, 100},
+                                                     [](const auto& msg) { return msg->size(); });
+  for (int i = 0; i < 1024; ++i) by_bytes.append(payload);
+  ASSERT_EQ(by_bytes.size(), 1);
+  ASSERT_EQ(payload.use_count(), 2);
+
+  // max_messages 5 rounds up to 8 slots: the 3 spare ones must not keep
+  // evicted payloads alive either.
+  RetainedLog<std::shared_ptr<std::string>> by_count({5, 0});
+  for (int i = 0; i < 20; ++i) by_count.append(payload);
+  ASSERT_EQ(payload.use_count(), 2 + 5);
+}
+
+TEST(RetainedLog, SeekAndReplay) {
+  RetainedLog<int> log({16, 0});
+  for (int i = 0; i < 12; ++i) log.append(i);
+
+  auto cursor = log.cursor(0);
+  std::vector<int> out;
+  ASSERT_EQ(cursor.next(out, 5), 5);
+  ASSERT_EQ(cursor.position(), 5);
+
+  // A restarted consumer replays from its last committed offset.
+  ASSERT_EQ(cursor.seek(3), 3);
+  out.clear();
+  ASSERT_EQ(cursor.next(out, 100), 9);
+  ASSERT_EQ(out.front(), 3);
+  ASSERT_EQ(out.back(), 11);
+  ASSERT_EQ(cursor.next(out, 100), 0);
+  ASSERT_THROW(cursor.seek(13), std::out_of_range);
+}
+
+TEST(RetainedLog, LappedCursorSkipsAhead) {
+  RetainedLog<int> log({4, 0});
+  log.append(0);
+  auto cursor = log.cursor(0);
+  for (int i = 1; i < 10; ++i) log.append(i);
+
+  std::vector<int> out;
+  ASSERT_EQ(cursor.next(out, 10), 4);
+  ASSERT_EQ(out.front(), 6);
+  ASSERT_EQ(cursor.lagged(), 6);
+  ASSERT_EQ(cursor.seek(0), 6);
+}
+
+TEST(RetainedLog, WrapAroundReadIsContiguous) {
+  RetainedLog<int> log({8, 0});
+  for (int i = 0; i < 13; ++i) log.append(i);
+
+  std::vector<int> out;
+  ASSERT_EQ(log.read(log.begin_offset(), out, 8), 8);
+  for (int i = 0; i < 8; ++i) ASSERT_EQ(out[i], i + 5);
+}
+
+TEST(RetainedLog, NextWaitSeesConcurrentAppend) {
+  RetainedLog<int> log({64, 0});
+  auto cursor = log.cursor(0);
+  std::vector<int> out;
+  ASSERT_EQ(cursor.next_wait(out, 10, 1ms), 0);
+
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(5ms);
+    log.append(42);
+  });
+  ASSERT_EQ(cursor.next_wait(out, 10, 5s), 1);
+  ASSERT_EQ(out[0], 42);
+  producer.join();
+}
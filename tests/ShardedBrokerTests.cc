@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <sched.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <broker_system/ShardedBroker.h>
+
+TEST(ShardedBroker, ConstructorException) {
+  ShardedBrokerOptions options;
+  options.shards = 0;
+  ASSERT_THROW(ShardedBroker<int>([](const int&, size_t) {}, nullptr, options), std::invalid_argument);
+  ASSERT_THROW(ShardedBroker<int>(nullptr, nullptr), std::invalid_argument);
+}
+
+TEST(ShardedBroker, PinCurrentThread) {
+  const std::vector<size_t> cpus = allowed_cpus();
+  ASSERT_FALSE(cpus.empty());
+  const size_t cpu = cpus.back();
+  bool pinned = false;
+  int ran_on = -1;
+  std::thread([&]() {
+    pinned = pin_current_thread(cpu);
+    ran_on = sched_getcpu();
+  }).join();
+  ASSERT_TRUE(pinned);
+  ASSERT_EQ(ran_on, static_cast<int>(cpu));
+}
+
+TEST(ShardedBroker, RoutesEveryMessageToItsShard) {
+  ShardedBrokerOptions options;
+  options.shards = 3;
+  options.channel_capacity = 64;
+  std::atomic<long> sum{0};
+  std::atomic<int> misrouted{0};
+  std::atomic<int> rejected{0};
+  ShardedBroker<int> broker(
+      [&](const int& msg, size_t shard) {
+        sum += msg;
+        if (static_cast<size_t>(msg) % 3 != shard) ++misrouted;
+      },
+      [](const int& msg) { return static_cast<size_t>(msg); }, options);
+
+  for (size_t shard = 0; shard < broker.shards(); ++shard) {
+    broker.run_producer(shard, [&](ShardedBroker<int>::Producer& producer) {
+      for (int i = 0; i < 3000; ++i) {
+        if (!producer.publish(i)) ++rejected;
+      }
+    });
+  }
+  broker.stop();
+
+  ASSERT_EQ(rejected, 0);
+  ASSERT_EQ(broker.processed(), 9000);
+  ASSERT_EQ(sum, 3L * (2999L * 3000L / 2));
+  ASSERT_EQ(misrouted, 0);
+  for (size_t shard = 0; shard < broker.shards(); ++shard) {
+    ASSERT_EQ(broker.processed(shard), 3000);
+  }
+}
+
+TEST(ShardedBroker, ConsumersRunOnTheirCpu) {
+  const int cpu = static_cast<int>(allowed_cpus().front());
+  ShardedBrokerOptions options;
+  options.shards = 2;
+  options.cpus = {allowed_cpus().front(), allowed_cpus().front()};
+  std::atomic<int> elsewhere{0};
+  ShardedBroker<int> broker(
+      [&](const int&, size_t) {
+        if (sched_getcpu() != cpu) ++elsewhere;
+      },
+      nullptr, options);
+  ASSERT_EQ(broker.cpu_of(1), static_cast<size_t>(cpu));
+
+  auto producer = broker.producer(1);
+  for (int i = 0; i < 100; ++i) producer.publish(i);
+  broker.stop();
+  ASSERT_EQ(broker.pin_failures(), 0);
+  ASSERT_EQ(broker.processed(1), 100);
+  ASSERT_EQ(broker.processed(0), 0);
+  ASSERT_EQ(elsewhere, 0);
+  ASSERT_FALSE(producer.publish(1));
+}
+
+TEST(ShardedBroker, CountsPinFailures) {
+  ShardedBrokerOptions options;
+  options.shards = 1;
+  options.cpus = {CPU_SETSIZE};  // no such CPU
+  ShardedBroker<int> broker([](const int&, size_t) {}, nullptr, options);
+  broker.stop();
+  ASSERT_EQ(broker.pin_failures(), 1);
+}
+
+// Publishers outside run_producer racing stop(): every publish that returned
+// true must be handled, and none may hang on a full channel.
+TEST(ShardedBroker, PublishRacingStopIsNeverLost) {
+  for (int round = 0; round < 20; ++round) {
+    ShardedBrokerOptions options;
+    options.shards = 2;
+    options.channel_capacity = 2;
+    options.pin_threads = false;
+    ShardedBroker<int> broker([](const int&, size_t) {}, nullptr, options);
+
+    std::atomic<uint64_t> accepted{0};
+    std::vector<std::thread> publishers;
+    for (size_t shard = 0; shard < 2; ++shard) {
+      publishers.emplace_back([&, shard]() {
+        auto producer = broker.producer(shard);
+        while (producer.publish(1)) ++accepted;
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    broker.stop();
+    for (auto& t : publishers) t.join();
+    ASSERT_EQ(broker.processed(), accepted.load());
+  }
+}
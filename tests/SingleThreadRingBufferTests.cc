@@ -137,6 +137,37 @@ TEST(SingleThread, WrapAround) {
   ASSERT_TRUE(rbuf.empty());
 }
 
+TEST(SingleThread, PopBulk) {
+  RingBuffer<int> rbuf(5);
+  getFilledBuffer(rbuf, 5);
+
+  std::vector<int> out;
+  ASSERT_EQ(rbuf.pop_bulk(out, 3), 3);
+  ASSERT_EQ(out, std::vector<int>({0, 1, 2}));
+  ASSERT_EQ(rbuf.pop_bulk(out, 10), 2);
+  ASSERT_EQ(out, std::vector<int>({0, 1, 2, 3, 4}));
+  ASSERT_TRUE(rbuf.empty());
+}
+
+TEST(SingleThread, PopBulkEndOfStream) {
+  RingBuffer<int> rbuf(3);
+  rbuf.push(1);
+  rbuf.close();
+
+  std::vector<int> out;
+  ASSERT_EQ(rbuf.try_pop_bulk(out, 3), 1);
+  ASSERT_EQ(rbuf.try_pop_bulk(out, 3), 0);
+  ASSERT_EQ(rbuf.pop_bulk(out, 3), 0);
+}
+
+TEST(SingleThread, PopBulkZeroIsRejected) {
+  RingBuffer<int> rbuf(3);
+  rbuf.push(1);
+  std::vector<int> out;
+  ASSERT_THROW(rbuf.pop_bulk(out, 0), std::invalid_argument);
+  ASSERT_EQ(rbuf.size(), 1);
+}
+
 int main(int argc, char** argv) {
 //  std::ios::sync_with_stdio(false);
   testing::InitGoogleTest(&argc, argv);
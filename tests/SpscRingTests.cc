@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <thread>
+
+#include <broker_system/SpscRing.h>
+
+TEST(SpscRing, ConstructorException) {
+  ASSERT_THROW(SpscRing<int> ring(0), std::invalid_argument);
+}
+
+TEST(SpscRing, CapacityRoundedToPowerOfTwo) {
+  SpscRing<int> ring(5);
+  ASSERT_EQ(ring.capacity(), 8);
+}
+
+TEST(SpscRing, PushPopFull) {
+  SpscRing<int> ring(4);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(ring.try_push(i));
+  }
+  ASSERT_FALSE(ring.try_push(4));
+  ASSERT_EQ(ring.size(), 4);
+
+  int msg;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(ring.try_pop(msg));
+    ASSERT_EQ(msg, i);
+  }
+  ASSERT_FALSE(ring.try_pop(msg));
+  ASSERT_TRUE(ring.empty());
+}
+
+TEST(SpscRing, ProducerConsumerKeepOrder) {
+  SpscRing<int> ring(16);
+  const int total = 100000;
+
+  std::thread producer([&]() {
+    for (int i = 0; i < total; ++i) {
+      while (!ring.try_push(i)) std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  while (expected < total) {
+    int msg;
+    if (ring.try_pop(msg)) {
+      ASSERT_EQ(msg, expected++);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+}
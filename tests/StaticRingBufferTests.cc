@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+
+#include <broker_system/StaticRingBuffer.h>
+
+static_assert(StaticRingBuffer<int, 64>::capacity() == 64);
+static_assert(StaticRingBuffer<int, 1024>::kMask == 1023);
+static_assert(sizeof(StaticRingBuffer<uint32_t, 8>) == 8 * sizeof(uint32_t) + 2 * sizeof(size_t));
+
+// Pushes 0..n-1 through a ring of 4 with pops in between, wrapping the
+// indices several times; evaluated entirely at compile time below.
+constexpr int wrap_sum(int n) {
+  StaticRingBuffer<int, 4> ring;
+  int sum = 0;
+  int value = 0;
+  for (int i = 0; i < n; ++i) {
+    if (!ring.try_push(i)) {
+      ring.try_pop(value);
+      sum += value;
+      ring.try_push(i);
+    }
+  }
+  while (ring.try_pop(value)) sum += value;
+  return sum;
+}
+
+static_assert(wrap_sum(10) == 45);
+static_assert(wrap_sum(1000) == 499500);
+
+constexpr bool fills_to_capacity() {
+  StaticRingBuffer<int, 2> ring;
+  return ring.empty() && ring.try_push(1) && ring.try_push(2) && ring.full() &&
+         !ring.try_push(3) && ring.size() == 2 && ring.available() == 0 &&
+         ring.front() == 1 && ring[1] == 2;
+}
+
+static_assert(fills_to_capacity());
+
+TEST(StaticRingBuffer, FifoOrderAcrossWrap) {
+  StaticRingBuffer<std::string, 4> ring;
+  std::string out;
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 3; ++i) ASSERT_TRUE(ring.try_push(std::to_string(round * 3 + i)));
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(ring.try_pop(out));
+      ASSERT_EQ(out, std::to_string(round * 3 + i));
+    }
+  }
+  ASSERT_TRUE(ring.empty());
+  ASSERT_FALSE(ring.try_pop(out));
+}
+
+TEST(StaticRingBuffer, IndexAndClear) {
+  StaticRingBuffer<int, 8> ring;
+  int out;
+  for (int i = 0; i < 6; ++i) ring.try_push(i);
+  ring.try_pop(out);
+  ring.try_pop(out);
+  for (int i = 6; i < 10; ++i) ring.try_push(i);
+  ASSERT_TRUE(ring.full());
+  for (size_t i = 0; i < ring.size(); ++i) ASSERT_EQ(ring[i], static_cast<int>(i) + 2);
+  ring.front() = 42;
+  ASSERT_EQ(ring[0], 42);
+  ring.clear();
+  ASSERT_TRUE(ring.empty());
+  ASSERT_EQ(ring.available(), 8);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <broker_system/LockFreeRingBuffer.h>
+#include <broker_system/RingBuffer.h>
+
+// Stress and linearizability harness: P producers stamp every message with
+// (producer, sequence) and push for a fixed duration while C consumers pop.
+// Each consumer must see every producer's sequence strictly increasing
+// (FIFO), and the union over consumers must be exactly 1..sent per producer
+// (no loss, no duplication). Sizes come from the environment so the same
+// binary serves the quick default run and long soak or sanitizer runs:
+//   BROKER_STRESS_PRODUCERS (default 2), BROKER_STRESS_CONSUMERS (default 2),
+//   BROKER_STRESS_MS (default 200), BROKER_STRESS_CAPACITY (default 64).
+
+struct StressMessage {
+  uint32_t producer = 0;
+  uint32_t sequence = 0;
+};
+
+static size_t env_or(const char* name, size_t fallback) {
+  const char* value = std::getenv(name);
+  return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+// Blocking rings: pop() returns false once closed and drained.
+template <typename Ring>
+struct BlockingQueue {
+  explicit BlockingQueue(size_t capacity) : ring(capacity) {}
+  void push(const StressMessage& msg) { ring.push(msg); }
+  bool pop(StressMessage& msg) { return ring.pop(msg); }
+  void close() { ring.close(); }
+  Ring ring;
+};
+
+// Non-blocking rings get the same surface by spinning.
+struct SpinningQueue {
+  explicit SpinningQueue(size_t capacity) : ring(capacity) {}
+  void push(const StressMessage& msg) {
+    while (!ring.try_push(msg)) std::this_thread::yield();
+  }
+  bool pop(StressMessage& msg) {
+    while (!ring.try_pop(msg)) {
+      if (closed.load(std::memory_order_acquire) && ring.empty()) {
+        return ring.try_pop(msg);
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+  void close() { closed.store(true, std::memory_order_release); }
+  LockFreeRingBuffer<StressMessage> ring;
+  std::atomic<bool> closed{false};
+};
+
+template <typename Queue>
+static void run_stress(const std::string& name) {
+  const size_t producers = std::max<size_t>(env_or("BROKER_STRESS_PRODUCERS", 2), 1);
+  const size_t consumers = std::max<size_t>(env_or("BROKER_STRESS_CONSUMERS", 2), 1);
+  const auto duration = std::chrono::milliseconds(env_or("BROKER_STRESS_MS", 200));
+  Queue queue(std::max<size_t>(env_or("BROKER_STRESS_CAPACITY", 64), 1));
+
+  std::atomic<bool> stop{false};
+  std::vector<uint32_t> sent(producers, 0);
+  // seen[c][p]: sequences of producer p in the order consumer c popped them.
+  std::vector<std::vector<std::vector<uint32_t>>> seen(
+      consumers, std::vector<std::vector<uint32_t>>(producers));
+  std::vector<size_t> out_of_order(consumers, 0);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t c = 0; c < consumers; ++c) {
+    threads.emplace_back([&, c]() {
+      StressMessage msg;
+      while (queue.pop(msg)) {
+        auto& log = seen[c][msg.producer];
+        if (!log.empty() && msg.sequence <= log.back()) ++out_of_order[c];
+        log.push_back(msg.sequence);
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (size_t p = 0; p < producers; ++p) {
+    writers.emplace_back([&, p]() {
+      uint32_t sequence = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        queue.push({static_cast<uint32_t>(p), ++sequence});
+      }
+      sent[p] = sequence;
+    });
+  }
+  std::this_thread::sleep_for(duration);
+  stop = true;
+  for (auto& t : writers) t.join();
+  queue.close();
+  for (auto& t : threads) t.join();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  uint64_t total = 0;
+  for (size_t c = 0; c < consumers; ++c) {
+    ASSERT_EQ(out_of_order[c], 0) << "consumer " << c << " saw a producer out of order";
+  }
+  for (size_t p = 0; p < producers; ++p) {
+    std::vector<uint32_t> merged;
+    for (size_t c = 0; c < consumers; ++c) {
+      merged.insert(merged.end(), seen[c][p].begin(), seen[c][p].end());
+    }
+    std::sort(merged.begin(), merged.end());
+    ASSERT_EQ(merged.size(), sent[p]) << "producer " << p << " lost or duplicated messages";
+    for (uint32_t i = 0; i < merged.size(); ++i) {
+      ASSERT_EQ(merged[i], i + 1) << "producer " << p;
+    }
+    total += sent[p];
+  }
+
+  std::cout << "[ stress   ] " << std::left << std::setw(26) << name << std::right
+            << producers << "P/" << consumers << "C " << std::setw(10) << total
+            << " msgs " << std::fixed << std::setprecision(0) << std::setw(12)
+            << total / elapsed.count() << " msgs/s\n";
+}
+
+TEST(Stress, RingBufferMutex) {
+  run_stress<BlockingQueue<RingBuffer<StressMessage>>>("RingBuffer<Mutex>");
+}
+
+TEST(Stress, RingBufferSpinLock) {
+  run_stress<BlockingQueue<RingBuffer<StressMessage, SpinLock>>>("RingBuffer<SpinLock>");
+}
+
+TEST(Stress, LockFreeRingBuffer) {
+  run_stress<SpinningQueue>("LockFreeRingBuffer");
+}
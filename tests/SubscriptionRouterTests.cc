@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <broker_system/LoadGenerator.h>
+#include <broker_system/SubscriptionRouter.h>
+
+static std::vector<VideoEvent> make_events(size_t n) {
+  LoadProfile profile;
+  EventStream stream(profile, 0);
+  std::vector<VideoEvent> events;
+  stream.next_batch(events, n);
+  return events;
+}
+
+TEST(SubscriptionRouter, VectorMatchEqualsScalar) {
+  auto events = make_events(1003);  // not a multiple of 16: exercises the tail
+  events[0].video_id = UINT32_MAX;
+  EventHeaders headers;
+  headers.build(events.data(), events.size());
+
+  std::vector<EventFilter> filters(5);
+  filters[1].type_mask = type_bit(EventType::Like);
+  filters[2].video_min = 10;
+  filters[2].video_max = 20;
+  filters[3].creator = 3;
+  filters[3].type_mask = type_bit(EventType::View) | type_bit(EventType::Comment);
+  filters[4].video_min = 2000;  // above every generated video except row 0
+
+  std::vector<uint8_t> mask(events.size());
+  for (const EventFilter& filter : filters) {
+    match_headers(headers, filter, mask.data());
+    for (size_t i = 0; i < events.size(); ++i) {
+      ASSERT_EQ(mask[i] != 0, filter.matches(events[i])) << i;
+    }
+  }
+}
+
+TEST(SubscriptionRouter, PushesOnlyMatches) {
+  auto events = make_events(5000);
+  RingBuffer<VideoEvent> likes(5000), hot_range(5000), creator(5000);
+  SubscriptionRouter router;
+  EventFilter like_filter;
+  like_filter.type_mask = type_bit(EventType::Like);
+  EventFilter range_filter;
+  range_filter.video_max = 9;
+  EventFilter creator_filter;
+  creator_filter.creator = 7;
+  size_t a = router.subscribe(like_filter, likes);
+  size_t b = router.subscribe(range_filter, hot_range);
+  size_t c = router.subscribe(creator_filter, creator);
+
+  size_t pushed = router.route(events);
+  ASSERT_EQ(pushed, likes.size() + hot_range.size() + creator.size());
+  ASSERT_EQ(router.delivered(a) + router.filtered(a), events.size());
+  ASSERT_GT(likes.size(), 0);
+  ASSERT_LT(likes.size(), events.size());
+
+  VideoEvent event;
+  while (likes.try_pop(event)) ASSERT_EQ(event.type, EventType::Like);
+  while (hot_range.try_pop(event)) ASSERT_LE(event.video_id, 9);
+  while (creator.try_pop(event)) ASSERT_EQ(event.creator_id, 7);
+  ASSERT_EQ(router.delivered(b) + router.delivered(c),
+            static_cast<uint64_t>(pushed) - router.delivered(a));
+}
+
+TEST(SubscriptionRouter, RunPropagatesEndOfStream) {
+  RingBuffer<VideoEvent> source(64), comments(16);
+  SubscriptionRouter router(std::chrono::seconds(10));  // never drop here
+  EventFilter filter;
+  filter.type_mask = type_bit(EventType::Comment);
+  router.subscribe(filter, comments);
+
+  std::thread routing([&]() { router.run(source, 8); });
+  std::thread producer([&]() {
+    for (uint32_t i = 0; i < 200; ++i) {
+      VideoEvent event;
+      event.sequence = i + 1;
+      event.type = i % 4 == 0 ? EventType::Comment : EventType::View;
+      source.push(event);
+    }
+    source.close();
+  });
+  const size_t expected = 50;
+
+  std::vector<uint64_t> sequences;
+  VideoEvent event;
+  while (comments.pop(event)) sequences.push_back(event.sequence);
+  producer.join();
+  routing.join();
+
+  ASSERT_EQ(sequences.size(), expected);
+  for (size_t i = 1; i < sequences.size(); ++i) {
+    ASSERT_GT(sequences[i], sequences[i - 1]);
+  }
+  ASSERT_EQ(router.filtered(0), 200 - expected);
+  ASSERT_EQ(router.dropped(0), 0);
+}
+
+TEST(SubscriptionRouter, RunRejectsZeroBatch) {
+  RingBuffer<VideoEvent> source(4), queue(4);
+  SubscriptionRouter router;
+  router.subscribe(EventFilter{}, queue);
+  ASSERT_THROW(router.run(source, 0), std::invalid_argument);
+  ASSERT_FALSE(queue.closed());
+}
+
+TEST(SubscriptionRouter, ClosedQueueCountsDropped) {
+  std::vector<VideoEvent> batch(10);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i].type = i % 2 == 0 ? EventType::Like : EventType::View;
+  }
+  RingBuffer<VideoEvent> likes(10);
+  SubscriptionRouter router;
+  EventFilter filter;
+  filter.type_mask = type_bit(EventType::Like);
+  router.subscribe(filter, likes);
+
+  likes.close();
+  ASSERT_EQ(router.route(batch), 0);
+  ASSERT_EQ(router.delivered(0), 0);
+  ASSERT_EQ(router.filtered(0), 5);
+  ASSERT_EQ(router.dropped(0), 5);
+
+  // Later batches keep being accounted for.
+  ASSERT_EQ(router.route(batch), 0);
+  ASSERT_EQ(router.filtered(0), 10);
+  ASSERT_EQ(router.dropped(0), 10);
+}
+
+TEST(SubscriptionRouter, SlowSubscriberDoesNotStallOthers) {
+  std::vector<VideoEvent> batch(100);
+  RingBuffer<VideoEvent> stuck(2), healthy(1000);
+  SubscriptionRouter router(std::chrono::milliseconds(10));
+  router.subscribe(EventFilter{}, stuck);  // never drained
+  router.subscribe(EventFilter{}, healthy);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < 5; ++round) {
+    ASSERT_EQ(router.route(batch), round == 0 ? 102 : 100);
+  }
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+
+  ASSERT_EQ(healthy.size(), 500);
+  ASSERT_EQ(router.delivered(1), 500);
+  ASSERT_EQ(router.delivered(0), 2);
+  ASSERT_EQ(router.dropped(0), 498);
+  ASSERT_EQ(router.filtered(0), 0);
+}
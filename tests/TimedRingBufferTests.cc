@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <broker_system/RingBuffer.h>
+
+using namespace std::chrono_literals;
+
+TEST(TimedWait, PopForTimesOutOnEmpty) {
+  RingBuffer<int> rbuf(3);
+  int msg;
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_FALSE(rbuf.pop_for(msg, 20ms));
+  ASSERT_GE(std::chrono::steady_clock::now() - start, 20ms);
+}
+
+TEST(TimedWait, PushForTimesOutOnFull) {
+  RingBuffer<int> rbuf(2);
+  ASSERT_TRUE(rbuf.push_for(1, 10ms));
+  ASSERT_TRUE(rbuf.push_for(2, 10ms));
+  ASSERT_FALSE(rbuf.push_for(3, 10ms));
+  ASSERT_EQ(rbuf.size(), 2);
+}
+
+TEST(TimedWait, PopUntilGetsLatePush) {
+  RingBuffer<int> rbuf(3);
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(5ms);
+    rbuf.push(42);
+  });
+  int msg = 0;
+  ASSERT_TRUE(rbuf.pop_until(msg, std::chrono::steady_clock::now() + 5s));
+  ASSERT_EQ(msg, 42);
+  producer.join();
+}
+
+TEST(TimedWait, PushUntilGetsFreedSlot) {
+  RingBuffer<int> rbuf(1);
+  rbuf.push(1);
+  std::thread consumer([&]() {
+    std::this_thread::sleep_for(5ms);
+    int msg;
+    rbuf.pop(msg);
+  });
+  ASSERT_TRUE(rbuf.push_until(2, std::chrono::steady_clock::now() + 5s));
+  consumer.join();
+}
+
+TEST(Close, PushFailsAfterClose) {
+  RingBuffer<int> rbuf(3);
+  rbuf.close();
+  ASSERT_TRUE(rbuf.closed());
+  ASSERT_FALSE(rbuf.push(1));
+  ASSERT_FALSE(rbuf.try_push(1));
+  ASSERT_FALSE(rbuf.push_for(1, 1ms));
+}
+
+TEST(Close, ConsumerDrainsThenEndOfStream) {
+  RingBuffer<int> rbuf(5);
+  for (int i = 0; i < 3; ++i) rbuf.push(i);
+  rbuf.close();
+
+  int msg;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(rbuf.pop(msg));
+    ASSERT_EQ(msg, i);
+  }
+  ASSERT_FALSE(rbuf.pop(msg));
+  ASSERT_FALSE(rbuf.pop_for(msg, 1ms));
+}
+
+TEST(Close, WakesBlockedWaiters) {
+  RingBuffer<int> full(1);
+  full.push(0);
+  RingBuffer<int> empty(1);
+  std::atomic<int> woken{0};
+
+  std::thread producer([&]() {
+    if (!full.push(1)) ++woken;
+  });
+  std::thread consumer([&]() {
+    int msg;
+    if (!empty.pop(msg)) ++woken;
+  });
+
+  std::this_thread::sleep_for(5ms);
+  full.close();
+  empty.close();
+  producer.join();
+  consumer.join();
+  ASSERT_EQ(woken, 2);
+}
+
+TEST(Close, GracefulShutdownLosesNothing) {
+  RingBuffer<int> rbuf(8);
+  std::atomic<long> push_sum{0}, pop_sum{0};
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < 2; ++c) {
+    consumers.emplace_back([&]() {
+      int msg;
+      while (rbuf.pop(msg)) pop_sum += msg;
+    });
+  }
+  for (int i = 1; i <= 1000; ++i) {
+    rbuf.push(i);
+    push_sum += i;
+  }
+  rbuf.close();
+  for (auto& t : consumers) t.join();
+  ASSERT_EQ(push_sum, pop_sum);
+}
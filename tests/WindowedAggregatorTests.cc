@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include <broker_system/WindowedAggregator.h>
+
+struct Emitted {
+  uint64_t start_ms;
+  uint64_t end_ms;
+  uint64_t events;
+  uint64_t video_views;
+  uint64_t creator_likes;
+  uint64_t watch_ms;
+};
+
+static VideoEvent make_event(uint64_t ts, uint32_t video, EventType type,
+                             uint32_t watch_ms = 0) {
+  VideoEvent event;
+  event.timestamp_ms = ts;
+  event.video_id = video;
+  event.creator_id = creator_of(video);
+  event.type = type;
+  event.watch_ms = watch_ms;
+  return event;
+}
+
+static WindowedAggregator::Callback collect(std::vector<Emitted>& out,
+                                            uint32_t video) {
+  return [&out, video](const WindowResult& w) {
+    out.push_back({w.start_ms, w.end_ms, w.events, w.videos.views[video],
+                   w.creators.likes[creator_of(video)],
+                   w.videos.watch_ms[video]});
+  };
+}
+
+TEST(WindowedAggregator, ConstructorException) {
+  ASSERT_THROW(WindowedAggregator(0, 0, nullptr), std::invalid_argument);
+  ASSERT_THROW(WindowedAggregator(100, 30, nullptr), std::invalid_argument);
+}
+
+TEST(WindowedAggregator, Tumbling) {
+  std::vector<Emitted> out;
+  WindowedAggregator agg(100, 100, collect(out, 7));
+
+  std::vector<VideoEvent> batch = {
+      make_event(0, 7, EventType::View),
+      make_event(50, 7, EventType::View),
+      make_event(60, 17, EventType::Like),
+      make_event(120, 7, EventType::View),
+      make_event(130, 7, EventType::WatchDuration, 4000),
+  };
+  agg.consume(batch);
+  ASSERT_EQ(out.size(), 1);
+  ASSERT_EQ(out[0].start_ms, 0);
+  ASSERT_EQ(out[0].end_ms, 100);
+  ASSERT_EQ(out[0].events, 3);
+  ASSERT_EQ(out[0].video_views, 2);
+  ASSERT_EQ(out[0].creator_likes, 1);
+
+  agg.flush();
+  ASSERT_EQ(out.size(), 2);
+  ASSERT_EQ(out[1].start_ms, 100);
+  ASSERT_EQ(out[1].video_views, 1);
+  ASSERT_EQ(out[1].creator_likes, 0);
+  ASSERT_EQ(out[1].watch_ms, 4000);
+}
+
+TEST(WindowedAggregator, Sliding) {
+  std::vector<Emitted> out;
+  WindowedAggregator agg(30, 10, collect(out, 1));
+
+  for (uint64_t ts = 0; ts < 50; ts += 10) {
+    agg.consume({make_event(ts, 1, EventType::View)});
+  }
+  agg.flush();
+
+  ASSERT_EQ(out.size(), 5);
+  std::vector<uint64_t> expected_views = {1, 2, 3, 3, 3};
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_EQ(out[i].end_ms, (i + 1) * 10);
+    ASSERT_EQ(out[i].video_views, expected_views[i]);
+  }
+}
+
+TEST(WindowedAggregator, GapExpiresWindow) {
+  std::vector<Emitted> out;
+  WindowedAggregator agg(30, 10, collect(out, 1));
+  agg.consume({make_event(0, 1, EventType::View)});
+  agg.consume({make_event(1000000, 1, EventType::View)});
+  agg.flush();
+
+  ASSERT_EQ(out.back().end_ms, 1000010);
+  ASSERT_EQ(out.back().video_views, 1);
+}
+
+TEST(WindowedAggregator, LateEventsCounted) {
+  std::vector<Emitted> out;
+  WindowedAggregator agg(10, 10, collect(out, 1));
+  agg.consume({make_event(25, 1, EventType::View),
+               make_event(5, 1, EventType::View)});
+  ASSERT_EQ(agg.late_events(), 1);
+}
+
+TEST(WindowedAggregator, RunRejectsZeroBatch) {
+  RingBuffer<VideoEvent> source(4);
+  source.push(make_event(0, 0, EventType::View));
+  WindowedAggregator agg(1000, 1000, [](const WindowResult&) {});
+  ASSERT_THROW(agg.run(source, 0), std::invalid_argument);
+  ASSERT_EQ(source.size(), 1);
+}
+
+TEST(WindowedAggregator, RunConsumesPopBulk) {
+  RingBuffer<VideoEvent> source(64);
+  std::vector<Emitted> out;
+  WindowedAggregator agg(1000, 1000, collect(out, 3));
+
+  std::thread producer([&]() {
+    for (uint64_t ts = 0; ts < 3000; ++ts) {
+      source.push(make_event(ts, ts % kVideoCount, EventType::View));
+    }
+    source.close();
+  });
+  agg.run(source, 32);
+  producer.join();
+
+  ASSERT_EQ(out.size(), 3);
+  for (auto& w : out) {
+    ASSERT_EQ(w.events, 1000);
+    ASSERT_EQ(w.video_views, 1);
+  }
+}